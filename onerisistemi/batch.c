@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "batch.h"
+
+// İş parçacıklarının ortak kullandığı durum
+typedef struct BatchState {
+    const BatchConfig *config;
+    const BatchHooks *hooks;
+    void *ctx;
+    int nextUser;          //sıradaki kullanıcı, atomik olarak artırılır
+    BatchBuffer *buffers;  //her kullanıcı için ayrı tampon, böylece kilit gerekmez
+} BatchState;
+
+int defaultThreadCount(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+static void bufferAppend(BatchBuffer *out, const char *text, size_t len) {
+    if (out->len + len + 1 > out->cap) {
+        size_t cap = out->cap ? out->cap : 256;
+        while (out->len + len + 1 > cap) {
+            cap *= 2;
+        }
+        out->data = (char *)realloc(out->data, cap);
+        out->cap = cap;
+    }
+    memcpy(out->data + out->len, text, len);
+    out->len += len;
+    out->data[out->len] = '\0';
+}
+
+// Bir algoritmanın sonucunu "kullanici<TAB>algoritma<TAB>film1,film2,..." satırı olarak ekler
+void batchWriteList(BatchBuffer *out, int user, const char *algorithm, const int *movies, int count) {
+    char text[32];
+    int len = snprintf(text, sizeof(text), "%d\t", user);
+    bufferAppend(out, text, len);
+    bufferAppend(out, algorithm, strlen(algorithm));
+    bufferAppend(out, "\t", 1);
+    for (int i = 0; i < count; i++) {
+        len = snprintf(text, sizeof(text), i == 0 ? "%d" : ",%d", movies[i]);
+        bufferAppend(out, text, len);
+    }
+    bufferAppend(out, "\n", 1);
+}
+
+static void *batchWorker(void *arg) {
+    BatchState *state = (BatchState *)arg;
+    void *threadState = state->hooks->threadInit ? state->hooks->threadInit(state->ctx) : NULL;
+
+    for (;;) {
+        int user = __atomic_fetch_add(&state->nextUser, 1, __ATOMIC_RELAXED);
+        if (user > state->config->lastUser) {
+            break;
+        }
+        BatchBuffer *out = &state->buffers[user - state->config->firstUser];
+        state->hooks->processUser(user, state->ctx, threadState, out);
+    }
+
+    if (state->hooks->threadFree) {
+        state->hooks->threadFree(threadState);
+    }
+    return NULL;
+}
+
+// Kullanıcı aralığını iş parçacıklarına dağıtır, bitince sonuçları kullanıcı sırasıyla dosyaya yazar
+// Başarılıysa 0, dosya açılamazsa -1 döner
+int runBatch(const BatchConfig *config, const BatchHooks *hooks, void *ctx) {
+    FILE *file = fopen(config->outputFile, "w");
+    if (!file) {
+        printf("Cikti dosyasi acilamadi: %s\n", config->outputFile);
+        return -1;
+    }
+
+    int userCount = config->lastUser - config->firstUser + 1;
+    int threads = config->threads > 0 ? config->threads : defaultThreadCount();
+    if (threads > userCount) {
+        threads = userCount;
+    }
+
+    BatchState state;
+    state.config = config;
+    state.hooks = hooks;
+    state.ctx = ctx;
+    state.nextUser = config->firstUser;
+    state.buffers = (BatchBuffer *)calloc(userCount, sizeof(BatchBuffer));
+
+    pthread_t *workers = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, batchWorker, &state);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    fprintf(file, "# kullanici\talgoritma\tfilmler\n");
+    for (int i = 0; i < userCount; i++) {
+        if (state.buffers[i].len > 0) {
+            fwrite(state.buffers[i].data, 1, state.buffers[i].len, file);
+        }
+        free(state.buffers[i].data);
+    }
+    free(state.buffers);
+    fclose(file);
+    return 0;
+}
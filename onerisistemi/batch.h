@@ -0,0 +1,38 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+
+// Toplu (batch) mod: veri bir kez yüklenir, bir kullanıcı aralığı için tüm öneriler
+// iş parçacıklarına dağıtılarak hesaplanır ve sonuçlar bir dosyaya yazılır.
+//
+// Çıktı dosyası sekmeyle ayrılmış satırlardan oluşur:
+//   kullanici <TAB> algoritma <TAB> film1,film2,...
+
+// Bir kullanıcının çıktı satırlarını biriktiren tampon
+typedef struct BatchBuffer {
+    char *data;
+    size_t len;
+    size_t cap;
+} BatchBuffer;
+
+typedef struct BatchConfig {
+    int firstUser;
+    int lastUser;       //dahil
+    int threads;        //0 ise çekirdek sayısı kadar
+    const char *outputFile;
+} BatchConfig;
+
+// Her iş parçacığı başlarken threadInit ile kendi çalışma alanını oluşturur,
+// sonra sıradaki kullanıcıyı alıp processUser'ı çağırır, en sonda threadFree ile temizler.
+typedef struct BatchHooks {
+    void *(*threadInit)(void *ctx);
+    void (*processUser)(int user, void *ctx, void *threadState, BatchBuffer *out);
+    void (*threadFree)(void *threadState);
+} BatchHooks;
+
+int runBatch(const BatchConfig *config, const BatchHooks *hooks, void *ctx);
+void batchWriteList(BatchBuffer *out, int user, const char *algorithm, const int *movies, int count);
+int defaultThreadCount(void);
+
+#endif
@@ -0,0 +1,469 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitmatrix.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(BITMATRIX_NO_AVX2)
+#include <immintrin.h>
+#define BITMATRIX_HAVE_AVX2 1
+#endif
+
+// 64 bayta hizalı, sıfırlanmış bellek (aligned_alloc boyutun hizanın katı olmasını istiyor)
+static void *alignedCalloc(size_t size) {
+    size_t rounded = (size + 63) & ~(size_t)63;
+    void *memory = aligned_alloc(64, rounded ? rounded : 64);
+    memset(memory, 0, rounded);
+    return memory;
+}
+
+// Puanlar önce filme, sonra kullanıcıya göre kararlı sayma sıralamasıyla (counting sort) dizilir;
+// sonuç (kullanıcı, film, dosya sırası) sırasındadır. Toplam iş O(puan + kullanıcı + film).
+RatingMatrix *buildRatingMatrix(const RatingSet *set, int users, int movies) {
+    RatingMatrix *matrix = (RatingMatrix *)calloc(1, sizeof(RatingMatrix));
+    matrix->users = users;
+    matrix->movies = movies;
+    long n = set->count;
+
+    long *movieStart = (long *)calloc(movies + 1, sizeof(long));
+    long *userStart = (long *)calloc(users + 1, sizeof(long));
+    for (long i = 0; i < n; i++) {
+        const Rating *r = &set->items[i];
+        if (r->user >= 1 && r->user <= users && r->movie >= 1 && r->movie <= movies &&
+            r->rating >= 1 && r->rating <= RATING_LEVELS) {
+            movieStart[r->movie]++;
+            userStart[r->user]++;
+        }
+    }
+    for (int m = 0; m < movies; m++) {
+        movieStart[m + 1] += movieStart[m];
+    }
+    for (int u = 0; u < users; u++) {
+        userStart[u + 1] += userStart[u];
+    }
+    long valid = userStart[users];
+
+    long *byMovie = (long *)malloc((valid > 0 ? valid : 1) * sizeof(long));
+    long *order = (long *)malloc((valid > 0 ? valid : 1) * sizeof(long));
+    for (long i = 0; i < n; i++) {
+        const Rating *r = &set->items[i];
+        if (r->user >= 1 && r->user <= users && r->movie >= 1 && r->movie <= movies &&
+            r->rating >= 1 && r->rating <= RATING_LEVELS) {
+            byMovie[movieStart[r->movie - 1]++] = i;
+        }
+    }
+    for (long i = 0; i < valid; i++) {
+        order[userStart[set->items[byMovie[i]].user - 1]++] = byMovie[i];
+    }
+    free(byMovie);
+    free(movieStart);
+    free(userStart);
+
+    // Satırlar yazılır; aynı çiftin tekrarlarından sadece sonuncusu (dosyada en son gelen) kalır
+    matrix->rowOffsets = (long *)calloc(users + 1, sizeof(long));
+    matrix->rowMovies = (int *)malloc((valid > 0 ? valid : 1) * sizeof(int));
+    matrix->rowRatings = (unsigned char *)malloc(valid > 0 ? valid : 1);
+    matrix->rowTimes = (unsigned int *)malloc((valid > 0 ? valid : 1) * sizeof(unsigned int));
+    long nonZeros = 0;
+    for (long i = 0; i < valid; i++) {
+        const Rating *r = &set->items[order[i]];
+        if (i + 1 < valid) {
+            const Rating *next = &set->items[order[i + 1]];
+            if (next->user == r->user && next->movie == r->movie) {
+                continue;
+            }
+        }
+        matrix->rowMovies[nonZeros] = r->movie - 1;
+        matrix->rowRatings[nonZeros] = (unsigned char)r->rating;
+        matrix->rowTimes[nonZeros] = r->timestamp;
+        nonZeros++;
+        matrix->rowOffsets[r->user] = nonZeros;
+    }
+    for (int u = 0; u < users; u++) {
+        if (matrix->rowOffsets[u + 1] < matrix->rowOffsets[u]) {
+            matrix->rowOffsets[u + 1] = matrix->rowOffsets[u];  //puanı olmayan kullanıcı
+        }
+    }
+    matrix->rowEnds = matrix->rowOffsets + 1;
+    matrix->nonZeros = nonZeros;
+    free(order);
+
+    // Sütunlar: kullanıcılar sırayla gezildiği için her sütun kullanıcıya göre sıralı çıkar
+    matrix->colOffsets = (long *)calloc(movies + 1, sizeof(long));
+    matrix->colUsers = (int *)malloc((nonZeros > 0 ? nonZeros : 1) * sizeof(int));
+    matrix->colRatings = (unsigned char *)malloc(nonZeros > 0 ? nonZeros : 1);
+    for (long i = 0; i < nonZeros; i++) {
+        matrix->colOffsets[matrix->rowMovies[i] + 1]++;
+    }
+    for (int m = 0; m < movies; m++) {
+        matrix->colOffsets[m + 1] += matrix->colOffsets[m];
+    }
+    long *cursor = (long *)malloc((movies > 0 ? movies : 1) * sizeof(long));
+    memcpy(cursor, matrix->colOffsets, movies * sizeof(long));
+    for (int u = 0; u < users; u++) {
+        for (long i = matrix->rowOffsets[u]; i < matrix->rowOffsets[u + 1]; i++) {
+            long slot = cursor[matrix->rowMovies[i]]++;
+            matrix->colUsers[slot] = u;
+            matrix->colRatings[slot] = matrix->rowRatings[i];
+        }
+    }
+    free(cursor);
+    matrix->colEnds = matrix->colOffsets + 1;
+
+    matrix->movieSum = (int *)malloc((movies > 0 ? movies : 1) * sizeof(int));
+    matrix->movieCount = (int *)malloc((movies > 0 ? movies : 1) * sizeof(int));
+    rebuildMovieStats(matrix);
+    buildBitPlanes(matrix);
+    return matrix;
+}
+
+void freeRatingMatrix(RatingMatrix *matrix) {
+    free(matrix->rowOffsets);
+    free(matrix->rowMovies);
+    free(matrix->rowRatings);
+    free(matrix->rowTimes);
+    free(matrix->colOffsets);
+    free(matrix->colUsers);
+    free(matrix->colRatings);
+    free(matrix->movieSum);
+    free(matrix->movieCount);
+    if (matrix->rowLimits != NULL) {
+        free(matrix->rowEnds);
+        free(matrix->colEnds);
+        free(matrix->rowLimits);
+        free(matrix->colLimits);
+    }
+    freeBitPlanes(matrix);
+    free(matrix);
+}
+
+// Satırlar (ya da sütunlar) için ortak büyüyebilen dizi: her satırın başı, sonu ve ayrılan yerin sonu.
+// times sadece satırlarda vardır (sütunlarda NULL).
+typedef struct SlackLines {
+    long *starts;
+    long *ends;
+    long *limits;
+    int **keys;
+    unsigned char **values;
+    unsigned int **times;
+    long *used;
+    long *capacity;
+} SlackLines;
+
+// Sıkışık satırları her birinin sonunda boş yer kalacak şekilde yeni dizilere kopyalar
+static void copySlack(const long *offsets, const long *ends, const int *keys, const unsigned char *values,
+                      const unsigned int *times, int lines, SlackLines *out) {
+    long total = 0;
+    for (int i = 0; i < lines; i++) {
+        long length = ends[i] - offsets[i];
+        total += length + length / 4 + 4;
+    }
+    *out->keys = (int *)malloc(total * sizeof(int));
+    *out->values = (unsigned char *)malloc(total);
+    if (out->times != NULL) {
+        *out->times = (unsigned int *)malloc(total * sizeof(unsigned int));
+    }
+    long position = 0;
+    for (int i = 0; i < lines; i++) {
+        long length = ends[i] - offsets[i];
+        memcpy(*out->keys + position, keys + offsets[i], length * sizeof(int));
+        memcpy(*out->values + position, values + offsets[i], length);
+        if (out->times != NULL) {
+            memcpy(*out->times + position, times + offsets[i], length * sizeof(unsigned int));
+        }
+        out->starts[i] = position;
+        out->ends[i] = position + length;
+        position += length + length / 4 + 4;
+        out->limits[i] = position;
+    }
+    *out->used = total;
+    *out->capacity = total;
+}
+
+// line satırında position'a (satır içi sıra) key/value ekler. Satırın yeri doluysa satır dizinin sonuna
+// iki kat yerle taşınır, dizi de gerekirse iki katına büyütülür; ekleme başına maliyet satırın kuyruğunu
+// kaydırmak kadar, taşıma maliyeti ise eklemelere bölününce sabittir.
+static void insertSlack(SlackLines *lines, int line, long position, int key, unsigned char value, unsigned int time) {
+    long start = lines->starts[line];
+    long length = lines->ends[line] - start;
+    if (lines->ends[line] == lines->limits[line]) {
+        long room = 2 * length + 4;
+        if (*lines->used + room > *lines->capacity) {
+            long capacity = *lines->capacity * 2;
+            if (capacity < *lines->used + room) {
+                capacity = *lines->used + room;
+            }
+            *lines->keys = (int *)realloc(*lines->keys, capacity * sizeof(int));
+            *lines->values = (unsigned char *)realloc(*lines->values, capacity);
+            if (lines->times != NULL) {
+                *lines->times = (unsigned int *)realloc(*lines->times, capacity * sizeof(unsigned int));
+            }
+            *lines->capacity = capacity;
+        }
+        long moved = *lines->used;
+        memcpy(*lines->keys + moved, *lines->keys + start, length * sizeof(int));
+        memcpy(*lines->values + moved, *lines->values + start, length);
+        if (lines->times != NULL) {
+            memcpy(*lines->times + moved, *lines->times + start, length * sizeof(unsigned int));
+        }
+        *lines->used += room;
+        lines->starts[line] = moved;
+        lines->ends[line] = moved + length;
+        lines->limits[line] = moved + room;
+        start = moved;
+    }
+    int *keys = *lines->keys + start;
+    unsigned char *values = *lines->values + start;
+    memmove(keys + position + 1, keys + position, (length - position) * sizeof(int));
+    memmove(values + position + 1, values + position, length - position);
+    keys[position] = key;
+    values[position] = value;
+    if (lines->times != NULL) {
+        unsigned int *times = *lines->times + start;
+        memmove(times + position + 1, times + position, (length - position) * sizeof(unsigned int));
+        times[position] = time;
+    }
+    lines->ends[line]++;
+}
+
+// Sıralı satırda key'in yeri (yoksa eklenmesi gereken yer)
+static long lowerBound(const int *keys, long start, long end, int key) {
+    while (start < end) {
+        long mid = (start + end) >> 1;
+        if (keys[mid] < key) {
+            start = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return start;
+}
+
+static SlackLines matrixRows(RatingMatrix *matrix) {
+    SlackLines lines = {matrix->rowOffsets, matrix->rowEnds, matrix->rowLimits, &matrix->rowMovies,
+                        &matrix->rowRatings, &matrix->rowTimes, &matrix->rowSlotsUsed, &matrix->rowSlotCount};
+    return lines;
+}
+
+static SlackLines matrixColumns(RatingMatrix *matrix) {
+    SlackLines lines = {matrix->colOffsets, matrix->colEnds, matrix->colLimits, &matrix->colUsers,
+                        &matrix->colRatings, NULL, &matrix->colSlotsUsed, &matrix->colSlotCount};
+    return lines;
+}
+
+RatingMatrix *copyGrowableMatrix(const RatingMatrix *source) {
+    RatingMatrix *matrix = (RatingMatrix *)calloc(1, sizeof(RatingMatrix));
+    int users = source->users;
+    int movies = source->movies;
+    matrix->users = users;
+    matrix->movies = movies;
+    matrix->nonZeros = source->nonZeros;
+    matrix->rowOffsets = (long *)malloc((users + 1) * sizeof(long));
+    matrix->rowEnds = (long *)malloc((users > 0 ? users : 1) * sizeof(long));
+    matrix->rowLimits = (long *)malloc((users > 0 ? users : 1) * sizeof(long));
+    matrix->colOffsets = (long *)malloc((movies + 1) * sizeof(long));
+    matrix->colEnds = (long *)malloc((movies > 0 ? movies : 1) * sizeof(long));
+    matrix->colLimits = (long *)malloc((movies > 0 ? movies : 1) * sizeof(long));
+
+    SlackLines rows = matrixRows(matrix);
+    copySlack(source->rowOffsets, source->rowEnds, source->rowMovies, source->rowRatings, source->rowTimes, users, &rows);
+    matrix->rowOffsets[users] = matrix->rowSlotsUsed;  //son eleman büyüyebilen matriste kullanılmaz
+    SlackLines columns = matrixColumns(matrix);
+    copySlack(source->colOffsets, source->colEnds, source->colUsers, source->colRatings, NULL, movies, &columns);
+    matrix->colOffsets[movies] = matrix->colSlotsUsed;
+
+    matrix->movieSum = (int *)malloc((movies > 0 ? movies : 1) * sizeof(int));
+    matrix->movieCount = (int *)malloc((movies > 0 ? movies : 1) * sizeof(int));
+    memcpy(matrix->movieSum, source->movieSum, movies * sizeof(int));
+    memcpy(matrix->movieCount, source->movieCount, movies * sizeof(int));
+    matrix->totalSum = source->totalSum;
+    matrix->totalCount = source->totalCount;
+    buildBitPlanes(matrix);
+    return matrix;
+}
+
+int setMatrixRating(RatingMatrix *matrix, int user, int movie, int rating, unsigned int timestamp) {
+    long at = findInRow(matrix, user, movie);
+    int old = at >= 0 ? matrix->rowRatings[at] : 0;
+    if (old == rating) {
+        return old;
+    }
+
+    long column = lowerBound(matrix->colUsers, matrix->colOffsets[movie], matrix->colEnds[movie], user);
+    if (old != 0) {
+        matrix->rowRatings[at] = (unsigned char)rating;
+        matrix->rowTimes[at] = timestamp;
+        matrix->colRatings[column] = (unsigned char)rating;
+    } else {
+        SlackLines rows = matrixRows(matrix);
+        long position = lowerBound(matrix->rowMovies, matrix->rowOffsets[user], matrix->rowEnds[user], movie);
+        insertSlack(&rows, user, position - matrix->rowOffsets[user], movie, (unsigned char)rating, timestamp);
+        SlackLines columns = matrixColumns(matrix);
+        insertSlack(&columns, movie, column - matrix->colOffsets[movie], user, (unsigned char)rating, 0);
+        matrix->nonZeros++;
+        matrix->movieCount[movie]++;
+        matrix->totalCount++;
+    }
+    matrix->movieSum[movie] += rating - old;
+    matrix->totalSum += rating - old;
+
+    if (matrix->wordsPerRow > 0) {
+        long word = (long)user * matrix->wordsPerRow + (movie >> 6);
+        uint64_t bit = 1ULL << (movie & 63);
+        matrix->watched[word] |= bit;
+        if (old != 0) {
+            matrix->planes[old - 1][word] &= ~bit;
+        }
+        matrix->planes[rating - 1][word] |= bit;
+    }
+    return old;
+}
+
+// Film istatistiklerini sütunlardan baştan hesaplar (her film için bir sıralı tarama)
+void rebuildMovieStats(RatingMatrix *matrix) {
+    matrix->totalSum = 0;
+    matrix->totalCount = 0;
+    for (int movie = 0; movie < matrix->movies; movie++) {
+        int sum = 0;
+        for (long i = matrix->colOffsets[movie]; i < matrix->colEnds[movie]; i++) {
+            sum += matrix->colRatings[i];
+        }
+        int count = (int)(matrix->colEnds[movie] - matrix->colOffsets[movie]);
+        matrix->movieSum[movie] = sum;
+        matrix->movieCount[movie] = count;
+        matrix->totalSum += sum;
+        matrix->totalCount += count;
+    }
+}
+
+// Düzlemlerin toplamı BIT_PLANES_MAX_BYTES'a sığıyorsa satırlardan kurulur, sığmıyorsa wordsPerRow 0 kalır
+void buildBitPlanes(RatingMatrix *matrix) {
+    int wordsPerRow = ((matrix->movies + 63) / 64 + 3) & ~3;
+    size_t planeSize = (size_t)matrix->users * wordsPerRow * sizeof(uint64_t);
+    matrix->wordsPerRow = 0;
+    matrix->watched = NULL;
+    for (int r = 0; r < RATING_LEVELS; r++) {
+        matrix->planes[r] = NULL;
+    }
+    if (planeSize == 0 || planeSize * (RATING_LEVELS + 1) > (size_t)BIT_PLANES_MAX_BYTES) {
+        return;
+    }
+
+    matrix->watched = (uint64_t *)alignedCalloc(planeSize);
+    for (int r = 0; r < RATING_LEVELS; r++) {
+        matrix->planes[r] = (uint64_t *)alignedCalloc(planeSize);
+    }
+    for (int u = 0; u < matrix->users; u++) {
+        for (long i = matrix->rowOffsets[u]; i < matrix->rowEnds[u]; i++) {
+            int movie = matrix->rowMovies[i];
+            long word = (long)u * wordsPerRow + (movie >> 6);
+            uint64_t bit = 1ULL << (movie & 63);
+            matrix->watched[word] |= bit;
+            matrix->planes[matrix->rowRatings[i] - 1][word] |= bit;
+        }
+    }
+    matrix->wordsPerRow = wordsPerRow;
+}
+
+void freeBitPlanes(RatingMatrix *matrix) {
+    free(matrix->watched);
+    for (int r = 0; r < RATING_LEVELS; r++) {
+        free(matrix->planes[r]);
+        matrix->planes[r] = NULL;
+    }
+    matrix->watched = NULL;
+    matrix->wordsPerRow = 0;
+}
+
+void ratingMatrixBytes(const RatingMatrix *matrix, long *sparseBytes, long *planeBytes) {
+    long rowSlots = matrix->rowLimits != NULL ? matrix->rowSlotCount : matrix->nonZeros;
+    long colSlots = matrix->colLimits != NULL ? matrix->colSlotCount : matrix->nonZeros;
+    long rowIndex = (long)(matrix->users + 1) * sizeof(long) * (matrix->rowLimits != NULL ? 3 : 1);
+    long colIndex = (long)(matrix->movies + 1) * sizeof(long) * (matrix->colLimits != NULL ? 3 : 1);
+    *sparseBytes = rowSlots * (long)(sizeof(int) + sizeof(unsigned char) + sizeof(unsigned int)) + rowIndex +
+                   colSlots * (long)(sizeof(int) + sizeof(unsigned char)) + colIndex +
+                   (long)matrix->movies * 2 * sizeof(int);
+    *planeBytes = (long)(RATING_LEVELS + 1) * matrix->users * matrix->wordsPerRow * sizeof(uint64_t);
+}
+
+// İki bit satırının AND'inin kaç biti 1
+static int andPopcountScalar(const uint64_t *a, const uint64_t *b, int words) {
+    int count = 0;
+    for (int i = 0; i < words; i++) {
+        count += __builtin_popcountll(a[i] & b[i]);
+    }
+    return count;
+}
+
+#ifdef BITMATRIX_HAVE_AVX2
+// AVX2 sürümü: 256 bit AND, sonra her baytın 4'er bitlik yarılarının bit sayısı tablo ile (vpshufb)
+// bulunur ve sad_epu8 ile 64 bitlik toplamlara çevrilir. words her zaman 4'ün katı.
+__attribute__((target("avx2")))
+static int andPopcountAvx2(const uint64_t *a, const uint64_t *b, int words) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    for (int i = 0; i < words; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_load_si256((const __m256i *)(a + i)),
+                                     _mm256_load_si256((const __m256i *)(b + i)));
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+                                         _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    return (int)(_mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) +
+                 _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3));
+}
+#endif
+
+typedef int (*AndPopcountFn)(const uint64_t *a, const uint64_t *b, int words);
+
+// Çekirdek her çağrıda işlemciye göre seçilir (mf.c'deki gibi). __builtin_cpu_supports başlangıçta doldurulmuş
+// bir bayrağı okur; seçim satır döngüsünün dışında, fonksiyon başına bir kez yapılır.
+static AndPopcountFn selectKernel(void) {
+#ifdef BITMATRIX_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return andPopcountAvx2;
+    }
+#endif
+    return andPopcountScalar;
+}
+
+int bitKernelUsesAvx2(void) {
+#ifdef BITMATRIX_HAVE_AVX2
+    return selectKernel() == andPopcountAvx2;
+#else
+    return 0;
+#endif
+}
+
+static void planeOneVsAll(const RatingMatrix *matrix, const uint64_t *plane, int user, int *counts, int accumulate) {
+    AndPopcountFn kernel = selectKernel();
+    int words = matrix->wordsPerRow;
+    const uint64_t *row = plane + (long)user * words;
+    for (int v = 0; v < matrix->users; v++) {
+        int count = kernel(row, plane + (long)v * words, words);
+        counts[v] = accumulate ? counts[v] + count : count;
+    }
+}
+
+void cowatchOneVsAll(const RatingMatrix *matrix, int user, int *counts) {
+    planeOneVsAll(matrix, matrix->watched, user, counts, 0);
+}
+
+void sameRatingOneVsAll(const RatingMatrix *matrix, int user, int *counts) {
+    for (int r = 0; r < RATING_LEVELS; r++) {
+        planeOneVsAll(matrix, matrix->planes[r], user, counts, r > 0);
+    }
+}
+
+// A bloğundaki her satır B bloğunun tüm satırlarıyla karşılaştırılır; B bloğu küçük tutulursa önbellekte kalır
+void cowatchBlock(const RatingMatrix *matrix, int firstA, int countA, int firstB, int countB, int *counts) {
+    AndPopcountFn kernel = selectKernel();
+    int words = matrix->wordsPerRow;
+    for (int i = 0; i < countA; i++) {
+        const uint64_t *row = matrix->watched + (long)(firstA + i) * words;
+        for (int j = 0; j < countB; j++) {
+            counts[(long)i * countB + j] = kernel(row, matrix->watched + (long)(firstB + j) * words, words);
+        }
+    }
+}
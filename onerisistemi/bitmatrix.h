@@ -0,0 +1,153 @@
+#ifndef BITMATRIX_H
+#define BITMATRIX_H
+
+#include <stdint.h>
+
+#include "loader.h"
+
+#define RATING_LEVELS 5
+
+// Bit düzlemlerinin toplamı (watched + RATING_LEVELS düzlem) bu boyutu geçecekse düzlemler kurulmaz.
+// ML-100K ~1.3 MB, ML-1M ~19 MB tutar; 10M/25M boyutunda sadece seyrek satırlar kullanılır.
+// -DBIT_PLANES_MAX_BYTES=0 ile düzlemler hiç kurulmaz (seyrek yolu küçük veride denemek için).
+#ifndef BIT_PLANES_MAX_BYTES
+#define BIT_PLANES_MAX_BYTES (256L << 20)
+#endif
+
+// Kullanıcı x film puan matrisi (seyrek, CSR). Tüm öneri yöntemlerinin okuduğu tek puan deposudur:
+// oneri1 ve oneri2'nin yöntemleri, dijkstra ve rastgele yürüyüş (grafiğin kenarları satır ve sütunlardır,
+// bkz. graph.h) puanları buradan okur; puanların ayrı bir liste, kenar ya da kayıt kopyası tutulmaz.
+// rowOffsets/rowMovies/rowRatings/rowTimes: kullanıcı satırları, her satırda filmler artan sırada
+//   (kullanıcı u'nun puanları rowOffsets[u] .. rowEnds[u] - 1 aralığında), puan başına 4 + 1 + 4 = 9 bayt
+// colOffsets/colUsers/colRatings: aynı puanların film sıralı kopyası, her sütunda kullanıcılar artan sırada
+//   (puan başına 4 + 1 = 5 bayt). Satırlara işaret eden bir sıra (permutation) dizisi de 4 bayt tutardı ve
+//   her sütun okuması satır dizilerine dağınık erişim olurdu; kopya filmden kullanıcılara giden yöntemleri
+//   (film-film benzerliği, mf, grafik) bitişik dizilerde tutar.
+// movieSum / movieCount: her filmin puan toplamı ve puan veren sayısı (filmin derecesi)
+// Seyrek kısım puan başına 14 bayt ve kullanıcı/film başına ofsetlerdir; kullanıcı x film ile büyümez.
+// Bit düzlemleri (aşağıda) buna eklenir: ML-100K'da puan başına ~12.7 bayt daha, toplam ~27 bayt.
+// olcum JSON'un "store" alanına iki kısmın gerçek boyutunu yazar (bkz. ratingMatrixBytes).
+//
+// Dosyadan ya da snapshot'tan kurulan matris sıkışıktır: satırlar arka arkaya durur, rowEnds = rowOffsets + 1.
+// copyGrowableMatrix ile alınan kopyada her satırın/sütunun sonunda boş yer bırakılır (rowLimits/colLimits),
+// setMatrixRating yeni puanı yerinde ekler; yer biterse satır dizinin sonuna iki kat yerle taşınır.
+//
+// Sığıyorsa ayrıca yoğun bit düzlemleri tutulur (wordsPerRow > 0):
+// watched: "puan vermiş mi" bit düzlemi, hücre başına 1 bit
+// planes[r - 1]: r puanı verilen hücrelerin bit düzlemi (r = 1..5)
+// Bit satırları AVX2 ile 256 bitlik parçalar halinde okunabilsin diye 4 kelimenin katına tamamlanır
+// ve 64 bayta hizalı ayrılır. Düzlemler yoksa hasRated satırda ikili arama yapar.
+typedef struct RatingMatrix {
+    int users;
+    int movies;
+    long nonZeros;                   //puan sayısı
+    long *rowOffsets;                //users + 1
+    long *rowEnds;                   //users, satır sonları (sıkışıkta rowOffsets + 1)
+    int *rowMovies;                  //nonZeros
+    unsigned char *rowRatings;       //nonZeros
+    unsigned int *rowTimes;          //nonZeros, puanın zaman damgası (u.data'nın 4. sütunu)
+    long *colOffsets;                //movies + 1
+    long *colEnds;                   //movies
+    int *colUsers;                   //nonZeros
+    unsigned char *colRatings;       //nonZeros
+    int wordsPerRow;                 //bir bit satırındaki 64 bitlik kelime sayısı, düzlem yoksa 0
+    uint64_t *watched;               //users * wordsPerRow
+    uint64_t *planes[RATING_LEVELS]; //her biri users * wordsPerRow
+    int *movieSum;                   //movies
+    int *movieCount;                 //movies
+    long totalSum;                   //tüm puanların toplamı
+    long totalCount;                 //toplam puan sayısı
+    long *rowLimits;                 //büyüyebilen matriste satıra ayrılan yerin sonu, sıkışıkta NULL
+    long *colLimits;
+    long rowSlotsUsed;               //satır dizilerinin kullanılan ve ayrılan boyu
+    long rowSlotCount;
+    long colSlotsUsed;
+    long colSlotCount;
+} RatingMatrix;
+
+// Puan dizisinden matrisi kurar (kullanıcı ve film 1 tabanlı gelir, matris 0 tabanlıdır).
+// Aynı kullanıcı-film çifti birden çok kez varsa dosyadaki son puan (ve zaman damgası) geçerlidir.
+RatingMatrix *buildRatingMatrix(const RatingSet *set, int users, int movies);
+void freeRatingMatrix(RatingMatrix *matrix);
+// Satır/sütun dizileri hazırken (örneğin snapshot'tan) film istatistiklerini ve sığıyorsa bit düzlemlerini kurar
+void rebuildMovieStats(RatingMatrix *matrix);
+void buildBitPlanes(RatingMatrix *matrix);
+void freeBitPlanes(RatingMatrix *matrix);
+// Seyrek dizilerin (satırlar, sütunlar, ofsetler, film istatistikleri; büyüyebilen matriste ayrılan boş yer
+// dahil) ve bit düzlemlerinin bayt cinsinden boyu
+void ratingMatrixBytes(const RatingMatrix *matrix, long *sparseBytes, long *planeBytes);
+// Sıkışık (ya da snapshot içindeki) matrisin büyüyebilen kopyası; bit düzlemleri ve istatistikler de kopyalanır
+RatingMatrix *copyGrowableMatrix(const RatingMatrix *matrix);
+// Büyüyebilen matriste puanı ekler ya da değiştirir (0 tabanlı, puan 1..5); satır, sütun, film istatistikleri
+// ve bit düzlemleri güncellenir, puan değiştiyse zaman damgası da timestamp olur. Eski puanı, yoksa 0 döner.
+int setMatrixRating(RatingMatrix *matrix, int user, int movie, int rating, unsigned int timestamp);
+
+// Kullanıcının puan verdiği filmler (artan sırada); puanlar rowRatings, zamanlar rowTimes içinde aynı yerdedir
+static inline const int *userRow(const RatingMatrix *matrix, int user, int *length) {
+    *length = (int)(matrix->rowEnds[user] - matrix->rowOffsets[user]);
+    return matrix->rowMovies + matrix->rowOffsets[user];
+}
+
+// Satırda filmin yeri, yoksa -1
+static inline long findInRow(const RatingMatrix *matrix, int user, int movie) {
+    long low = matrix->rowOffsets[user];
+    long high = matrix->rowEnds[user];
+    while (low < high) {
+        long mid = (low + high) >> 1;
+        if (matrix->rowMovies[mid] < movie) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < matrix->rowEnds[user] && matrix->rowMovies[low] == movie ? low : -1;
+}
+
+// Kullanıcı ve film 0 tabanlı
+static inline int getRating(const RatingMatrix *matrix, int user, int movie) {
+    long at = findInRow(matrix, user, movie);
+    return at >= 0 ? matrix->rowRatings[at] : 0;
+}
+
+static inline int hasRated(const RatingMatrix *matrix, int user, int movie) {
+    if (matrix->wordsPerRow > 0) {
+        return (matrix->watched[(long)user * matrix->wordsPerRow + (movie >> 6)] >> (movie & 63)) & 1;
+    }
+    return findInRow(matrix, user, movie) >= 0;
+}
+
+static inline const uint64_t *watchedRow(const RatingMatrix *matrix, int user) {
+    return matrix->watched + (long)user * matrix->wordsPerRow;
+}
+
+// Bir filmin puan veren kullanıcıları (artan sırada), puanlar colRatings içinde aynı yerdedir
+static inline const int *movieColumn(const RatingMatrix *matrix, int movie, int *length) {
+    *length = (int)(matrix->colEnds[movie] - matrix->colOffsets[movie]);
+    return matrix->colUsers + matrix->colOffsets[movie];
+}
+
+// Filmin ortalama puanı, hiç puan almadıysa 0
+static inline double movieMean(const RatingMatrix *matrix, int movie) {
+    int count = matrix->movieCount[movie];
+    return count > 0 ? (double)matrix->movieSum[movie] / count : 0.0;
+}
+
+// Az puan almış filmlerin ortalamasını genel ortalamaya doğru çeken (Bayes) ortalama:
+// (prior * genel ortalama + toplam) / (prior + sayı). prior, filme eklenen "sanal" oy sayısıdır.
+static inline double movieBayesMean(const RatingMatrix *matrix, int movie, double prior) {
+    double globalMean = matrix->totalCount > 0 ? (double)matrix->totalSum / matrix->totalCount : 0.0;
+    return (prior * globalMean + matrix->movieSum[movie]) / (prior + matrix->movieCount[movie]);
+}
+
+// Aşağıdaki çekirdekler bit düzlemlerini kullanır, sadece wordsPerRow > 0 iken çağrılmalıdır.
+// counts[v] = user ile v'nin ikisinin de izlediği film sayısı (tüm v için, v == user dahil)
+void cowatchOneVsAll(const RatingMatrix *matrix, int user, int *counts);
+// counts[v] = user ile v'nin aynı puanı verdiği film sayısı
+void sameRatingOneVsAll(const RatingMatrix *matrix, int user, int *counts);
+// counts[i * countB + j] = (firstA + i) ile (firstB + j) kullanıcılarının ortak film sayısı
+void cowatchBlock(const RatingMatrix *matrix, int firstA, int countA, int firstB, int countB, int *counts);
+
+// AVX2 kullanılıyorsa 1 döner (işlemci desteklemiyorsa skaler sürüm kullanılır)
+int bitKernelUsesAvx2(void);
+
+#endif
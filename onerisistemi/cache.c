@@ -0,0 +1,247 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+
+#define CACHE_ENTRY_GUESS 128  //tablo boyu için tahmini girdi boyu (bayt)
+
+static inline unsigned shardOf(int user) {
+    return (unsigned)user % CACHE_SHARDS;
+}
+
+static inline unsigned hashKey(int user, int algorithm, int k) {
+    unsigned long long h = ((unsigned long long)(unsigned)user << 32) ^ ((unsigned long long)(unsigned)k << 8) ^ (unsigned)algorithm;
+    h *= 0x9E3779B97F4A7C15ULL;
+    return (unsigned)(h >> 32);
+}
+
+ResultCache *createResultCache(size_t bytes, int users) {
+    ResultCache *cache = (ResultCache *)calloc(1, sizeof(ResultCache));
+    cache->users = users;
+    cache->userHeads = (CacheEntry **)calloc(users + 1, sizeof(CacheEntry *));
+
+    unsigned buckets = 64;
+    while ((size_t)buckets * CACHE_SHARDS * CACHE_ENTRY_GUESS < bytes) {
+        buckets *= 2;
+    }
+    size_t tableBytes = (size_t)buckets * sizeof(CacheEntry *);
+    for (int s = 0; s < CACHE_SHARDS; s++) {
+        CacheShard *shard = &cache->shards[s];
+        pthread_mutex_init(&shard->lock, NULL);
+        shard->buckets = (CacheEntry **)calloc(buckets, sizeof(CacheEntry *));
+        shard->bucketMask = buckets - 1;
+        shard->bytes = tableBytes;
+        shard->capacity = bytes / CACHE_SHARDS;
+    }
+    return cache;
+}
+
+void freeResultCache(ResultCache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+    for (int s = 0; s < CACHE_SHARDS; s++) {
+        CacheShard *shard = &cache->shards[s];
+        CacheEntry *entry = shard->lruHead;
+        while (entry != NULL) {
+            CacheEntry *next = entry->lruNext;
+            free(entry);
+            entry = next;
+        }
+        free(shard->buckets);
+        pthread_mutex_destroy(&shard->lock);
+    }
+    free(cache->userHeads);
+    free(cache);
+}
+
+static void lruUnlink(CacheShard *shard, CacheEntry *entry) {
+    if (entry->lruPrev != NULL) {
+        entry->lruPrev->lruNext = entry->lruNext;
+    } else {
+        shard->lruHead = entry->lruNext;
+    }
+    if (entry->lruNext != NULL) {
+        entry->lruNext->lruPrev = entry->lruPrev;
+    } else {
+        shard->lruTail = entry->lruPrev;
+    }
+}
+
+static void lruPushFront(CacheShard *shard, CacheEntry *entry) {
+    entry->lruPrev = NULL;
+    entry->lruNext = shard->lruHead;
+    if (shard->lruHead != NULL) {
+        shard->lruHead->lruPrev = entry;
+    } else {
+        shard->lruTail = entry;
+    }
+    shard->lruHead = entry;
+}
+
+// Girdiyi tüm listelerden çıkarıp bırakır (parçanın kilidi tutulurken)
+static void removeEntry(ResultCache *cache, CacheShard *shard, CacheEntry *entry) {
+    CacheEntry **link = &shard->buckets[hashKey(entry->user, entry->algorithm, entry->k) & shard->bucketMask];
+    while (*link != entry) {
+        link = &(*link)->hashNext;
+    }
+    *link = entry->hashNext;
+
+    lruUnlink(shard, entry);
+
+    if (entry->userPrev != NULL) {
+        entry->userPrev->userNext = entry->userNext;
+    } else {
+        cache->userHeads[entry->user] = entry->userNext;
+    }
+    if (entry->userNext != NULL) {
+        entry->userNext->userPrev = entry->userPrev;
+    }
+
+    if (entry->algorithmPrev != NULL) {
+        entry->algorithmPrev->algorithmNext = entry->algorithmNext;
+    } else {
+        shard->algorithmHeads[entry->algorithm] = entry->algorithmNext;
+    }
+    if (entry->algorithmNext != NULL) {
+        entry->algorithmNext->algorithmPrev = entry->algorithmPrev;
+    }
+
+    shard->bytes -= entry->bytes;
+    shard->stats.entries--;
+    free(entry);
+}
+
+static CacheEntry *findEntry(CacheShard *shard, int user, int algorithm, int k) {
+    CacheEntry *entry = shard->buckets[hashKey(user, algorithm, k) & shard->bucketMask];
+    while (entry != NULL && (entry->user != user || entry->algorithm != algorithm || entry->k != k)) {
+        entry = entry->hashNext;
+    }
+    return entry;
+}
+
+int cacheLookup(ResultCache *cache, int user, int algorithm, int k, int *out) {
+    CacheShard *shard = &cache->shards[shardOf(user)];
+    pthread_mutex_lock(&shard->lock);
+    CacheEntry *entry = findEntry(shard, user, algorithm, k);
+    int count = -1;
+    if (entry != NULL) {
+        if (shard->lruHead != entry) {
+            lruUnlink(shard, entry);
+            lruPushFront(shard, entry);
+        }
+        count = entry->count;
+        memcpy(out, entry->data, count * sizeof(int));
+        shard->stats.hits++;
+    } else {
+        shard->stats.misses++;
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return count;
+}
+
+void cacheInsert(ResultCache *cache, int user, int algorithm, int k, const int *movies, int count, const CacheDeps *deps) {
+    int depCount = deps->global ? 0 : deps->count;
+    size_t bytes = sizeof(CacheEntry) + (size_t)(count + depCount) * sizeof(int);
+    CacheShard *shard = &cache->shards[shardOf(user)];
+    if (algorithm < 0 || algorithm >= CACHE_MAX_ALGORITHMS || bytes > shard->capacity / 4) {
+        return;  //tek girdi parçanın dörtte birinden büyükse diğerlerini boşuna atmasın
+    }
+
+    pthread_mutex_lock(&shard->lock);
+    if (findEntry(shard, user, algorithm, k) != NULL) {  //aynı isteği başka bir iş parçacığı da hesaplamış
+        pthread_mutex_unlock(&shard->lock);
+        return;
+    }
+    while (shard->bytes + bytes > shard->capacity && shard->lruTail != NULL) {
+        removeEntry(cache, shard, shard->lruTail);
+        shard->stats.evictions++;
+    }
+
+    CacheEntry *entry = (CacheEntry *)malloc(bytes);
+    entry->bytes = bytes;
+    entry->user = user;
+    entry->algorithm = algorithm;
+    entry->k = k;
+    entry->count = count;
+    entry->depCount = depCount;
+    entry->global = deps->global;
+    entry->threshold = deps->threshold;
+    memcpy(entry->data, movies, count * sizeof(int));
+    if (depCount > 0) {
+        memcpy(entry->data + count, deps->items, depCount * sizeof(int));
+    }
+
+    CacheEntry **bucket = &shard->buckets[hashKey(user, algorithm, k) & shard->bucketMask];
+    entry->hashNext = *bucket;
+    *bucket = entry;
+    lruPushFront(shard, entry);
+    entry->userPrev = NULL;
+    entry->userNext = cache->userHeads[user];
+    if (entry->userNext != NULL) {
+        entry->userNext->userPrev = entry;
+    }
+    cache->userHeads[user] = entry;
+    entry->algorithmPrev = NULL;
+    entry->algorithmNext = shard->algorithmHeads[algorithm];
+    if (entry->algorithmNext != NULL) {
+        entry->algorithmNext->algorithmPrev = entry;
+    }
+    shard->algorithmHeads[algorithm] = entry;
+
+    shard->bytes += bytes;
+    shard->stats.entries++;
+    shard->stats.inserts++;
+    pthread_mutex_unlock(&shard->lock);
+}
+
+long cacheDropUser(ResultCache *cache, int user) {
+    CacheShard *shard = &cache->shards[shardOf(user)];
+    long dropped = 0;
+    pthread_mutex_lock(&shard->lock);
+    while (cache->userHeads[user] != NULL) {
+        removeEntry(cache, shard, cache->userHeads[user]);
+        dropped++;
+    }
+    shard->stats.invalidations += dropped;
+    pthread_mutex_unlock(&shard->lock);
+    return dropped;
+}
+
+long cacheDropIf(ResultCache *cache, int algorithm, CacheFilter filter, void *ctx) {
+    long dropped = 0;
+    for (int s = 0; s < CACHE_SHARDS; s++) {
+        CacheShard *shard = &cache->shards[s];
+        long shardDropped = 0;
+        pthread_mutex_lock(&shard->lock);
+        CacheEntry *entry = shard->algorithmHeads[algorithm];
+        while (entry != NULL) {
+            CacheEntry *next = entry->algorithmNext;
+            if (filter == NULL || entry->global || filter(entry, ctx)) {
+                removeEntry(cache, shard, entry);
+                shardDropped++;
+            }
+            entry = next;
+        }
+        shard->stats.invalidations += shardDropped;
+        pthread_mutex_unlock(&shard->lock);
+        dropped += shardDropped;
+    }
+    return dropped;
+}
+
+void cacheGetStats(ResultCache *cache, CacheStats *stats) {
+    memset(stats, 0, sizeof(CacheStats));
+    for (int s = 0; s < CACHE_SHARDS; s++) {
+        CacheShard *shard = &cache->shards[s];
+        pthread_mutex_lock(&shard->lock);
+        stats->hits += shard->stats.hits;
+        stats->misses += shard->stats.misses;
+        stats->inserts += shard->stats.inserts;
+        stats->evictions += shard->stats.evictions;
+        stats->invalidations += shard->stats.invalidations;
+        stats->entries += shard->stats.entries;
+        stats->bytes += shard->bytes;
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
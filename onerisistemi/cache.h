@@ -0,0 +1,90 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+// Sunucunun öneri sonucu önbelleği: (kullanıcı, algoritma, öneri sayısı) anahtarıyla son cevabın film listesi.
+// Veri değişmedikçe aynı istek aynı cevabı aldığı için tekrar gelen istek bir karma tablosu aramasıyla cevaplanır.
+//
+// Bellek sınırlıdır: girdiler boyutları (başlık + film + bağımlılık) toplamı sınırı aşınca en uzun süredir
+// kullanılmayandan başlanarak atılır (LRU). Kilit çekişmesi az olsun diye kullanıcıya göre CACHE_SHARDS
+// parçaya bölünür; her parçanın kendi kilidi, tablosu, LRU listesi ve bellek payı vardır.
+//
+// Geçersiz kılma kesindir, önbellek neyin neye bağlı olduğunu bilmez: girdi eklenirken çağıran bağımlılıklarını
+// (bir eşik ve düğüm/kullanıcı listesi) verir, veri değişince cacheDropUser ile kullanıcının tüm girdileri,
+// cacheDropIf ile bir algoritmanın sadece verilen koşula uyan girdileri atılır.
+
+#define CACHE_SHARDS 16
+#define CACHE_MAX_ALGORITHMS 16
+
+typedef struct CacheEntry {
+    struct CacheEntry *hashNext;
+    struct CacheEntry *lruPrev, *lruNext;          //parçanın LRU listesi, baş en son kullanılan
+    struct CacheEntry *userPrev, *userNext;        //aynı kullanıcının girdileri
+    struct CacheEntry *algorithmPrev, *algorithmNext;  //parçada aynı algoritmanın girdileri
+    size_t bytes;
+    int user;
+    int algorithm;
+    int k;
+    int count;         //öneri sayısı
+    int depCount;      //bağımlılık sayısı
+    int global;        //1 ise her değişiklikte atılır (bağımlılıkları tutulamayacak kadar geniş)
+    double threshold;  //algoritmaya göre anlamı değişir (ör. son önerinin puanı)
+    int data[];        //önce count film, sonra depCount bağımlılık
+} CacheEntry;
+
+typedef struct CacheDeps {
+    const int *items;
+    int count;
+    double threshold;
+    int global;
+} CacheDeps;
+
+typedef struct CacheStats {
+    long hits;
+    long misses;
+    long inserts;
+    long evictions;      //bellek sınırı yüzünden atılan
+    long invalidations;  //veri değiştiği için atılan
+    long entries;
+    size_t bytes;
+} CacheStats;
+
+typedef struct CacheShard {
+    pthread_mutex_t lock;
+    CacheEntry **buckets;
+    unsigned bucketMask;
+    CacheEntry *lruHead, *lruTail;
+    CacheEntry *algorithmHeads[CACHE_MAX_ALGORITHMS];
+    size_t bytes;
+    size_t capacity;
+    CacheStats stats;
+} CacheShard;
+
+typedef struct ResultCache {
+    CacheShard shards[CACHE_SHARDS];
+    CacheEntry **userHeads;  //users + 1, kullanıcının parçasının kilidiyle korunur
+    int users;
+} ResultCache;
+
+// Koşul 1 dönerse girdi atılır
+typedef int (*CacheFilter)(const CacheEntry *entry, void *ctx);
+
+// bytes toplam bellek sınırı (girdiler ve tablolar); kullanıcılar 1 tabanlı
+ResultCache *createResultCache(size_t bytes, int users);
+void freeResultCache(ResultCache *cache);
+
+// Bulursa öneri sayısını döner ve filmleri out'a yazar, yoksa -1
+int cacheLookup(ResultCache *cache, int user, int algorithm, int k, int *out);
+// Aynı anahtar varsa ya da girdi bir parçanın payından büyükse bir şey yapmaz
+void cacheInsert(ResultCache *cache, int user, int algorithm, int k, const int *movies, int count, const CacheDeps *deps);
+
+// Atılan girdi sayısını döner
+long cacheDropUser(ResultCache *cache, int user);
+// filter NULL ise algoritmanın tüm girdileri atılır
+long cacheDropIf(ResultCache *cache, int algorithm, CacheFilter filter, void *ctx);
+
+void cacheGetStats(ResultCache *cache, CacheStats *stats);
+
+#endif
@@ -0,0 +1,445 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "batch.h"
+#include "recommend1.h"
+#include "recommend2.h"
+#include "metrics.h"
+
+// Zamana göre çevrimdışı değerlendirme: her kullanıcının puanları zaman damgasına göre sıralanır, son -p oranı
+// (varsayılan %20, en az bir puan) test için ayrılır. İki programın tüm öneri yöntemleri sadece geçmiş
+// (eğitim) puanlarla kurulur; gizli faktör modeli de bu puanlarla eğitilir. trending (yarı ömür -T gün, varsayılan
+// TREND_HALF_LIFE_DAYS) her kullanıcı için onun en yeni eğitim puanının anına göre sorulur, o andan sonraki
+// puanları (başka kullanıcılarınkiler dahil) görmez. Her kullanıcı için öneriler
+// test puanlarından -e eşiği ve üstü (varsayılan 4) olanlarla karşılaştırılır.
+// Kullanım: ./degerlendir [-f puanlar] [-i filmler] [-k oneri] [-p oran] [-e esik] [-t thread] [-s tohum] [-w adim] [-L bant[xsatir]] [-T gun] [-o oneriler.tsv]
+//
+// Yöntem başına: precision@k (isabet / k), recall@k (isabet / ilgili film), NDCG@k (isabetlerin sıraya göre
+// 1 / log2(sıra + 1) ağırlıklı toplamı, en iyi sıralamanınkine bölünmüş) ve kapsama (en az bir kullanıcıya önerilen
+// film / tüm filmler). İlk üçü test puanlarında ilgili filmi olan kullanıcıların ortalamasıdır.
+// Aynı satırda yöntemin saniyedeki çağrı sayısı ve sonuçların sağlama toplamı da yazılır: hızlandırma amaçlı
+// bir değişiklikten sonra kalite ve sağlama toplamı aynı kalmalıdır. Kullanıcılar iş parçacıklarına dağıtılır,
+// rastgelelik kullanan yöntemler kullanıcıdan türetilen tohumla çalışır; faktör modeli de tek iş parçacığıyla
+// eğitilir, böylece sonuçlar iş parçacığı sayısından bağımsızdır. Öneri listeleri toplu mod biçiminde -o dosyasına yazılır.
+
+enum {
+    A_RANDOM, A_HIGH_DEGREE, A_SIMILAR_USER, A_NEAREST, A_ITEM, A_MF, A_GENRE, A_WALK, A_TRENDING, A_COUNT
+};
+
+static const char *algorithmNames[A_COUNT] = {
+    "random", "high_degree", "similar_user", "nearest", "item", "mf", "genre", "walk", "trending"
+};
+
+typedef struct EvalTotals {
+    int users;              //ilgili filmi olan (değerlendirilen) kullanıcı
+    double precision;
+    double recall;
+    double ndcg;
+    long long nanos;
+    long calls;
+    unsigned long long checksum;  //kullanıcıların sonuç özetlerinin toplamı, sıradan bağımsız
+} EvalTotals;
+
+// İş parçacıklarının ortak verisi
+typedef struct EvalContext {
+    int rec;
+    long steps;
+    unsigned long long seed;
+    const long *testOffsets;   //numUsers + 1, kullanıcı u'nun ilgili test filmleri testOffsets[u - 1] ..
+    const int *testMovies;     //artan sırada, 1 tabanlı
+    pthread_mutex_t lock;
+    EvalTotals totals[A_COUNT];
+    unsigned char *recommended; //A_COUNT * numMovies, önerilen filmler
+} EvalContext;
+
+typedef struct EvalWorker {
+    EvalContext *context;
+    DijkstraScratch *scratch;
+    ItemScratch *items;
+    MinHashScratch *similar;   //sadece -L ile
+    FactorScratch *factors;
+    unsigned *visits;
+    double *ratings;
+    int *movies;
+    ScoredItem *best;          //rec elemanlı, en iyi k seçimi için
+    EvalTotals totals[A_COUNT];
+    unsigned char *recommended;
+} EvalWorker;
+
+static long nowNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+static unsigned long long userSeed(unsigned long long seed, int user) {
+    return seed ^ (0x9E3779B97F4A7C15ULL * (unsigned long long)user);
+}
+
+static void *evalThreadInit(void *ctx) {
+    EvalContext *context = (EvalContext *)ctx;
+    EvalWorker *worker = (EvalWorker *)calloc(1, sizeof(EvalWorker));
+    worker->context = context;
+    worker->scratch = createDijkstraScratch(ratingMatrix);
+    worker->items = createItemScratch(numMovies);
+    worker->similar = userIndex != NULL ? createMinHashScratch(numUsers) : NULL;
+    worker->factors = createFactorScratch(numMovies);
+    worker->visits = (unsigned *)malloc((numUsers + numMovies) * sizeof(unsigned));
+    worker->ratings = (double *)malloc(context->rec * sizeof(double));
+    worker->movies = (int *)malloc(context->rec * sizeof(int));
+    worker->best = (ScoredItem *)malloc(context->rec * sizeof(ScoredItem));
+    worker->recommended = (unsigned char *)calloc((long)A_COUNT * numMovies, 1);
+    return worker;
+}
+
+// İş parçacığının toplamları ortak toplamlara eklenir
+static void evalThreadFree(void *threadState) {
+    EvalWorker *worker = (EvalWorker *)threadState;
+    EvalContext *context = worker->context;
+    pthread_mutex_lock(&context->lock);
+    for (int a = 0; a < A_COUNT; a++) {
+        EvalTotals *total = &context->totals[a];
+        const EvalTotals *part = &worker->totals[a];
+        total->users += part->users;
+        total->precision += part->precision;
+        total->recall += part->recall;
+        total->ndcg += part->ndcg;
+        total->nanos += part->nanos;
+        total->calls += part->calls;
+        total->checksum += part->checksum;
+    }
+    for (long i = 0; i < (long)A_COUNT * numMovies; i++) {
+        context->recommended[i] |= worker->recommended[i];
+    }
+    pthread_mutex_unlock(&context->lock);
+
+    freeDijkstraScratch(worker->scratch);
+    freeItemScratch(worker->items);
+    if (worker->similar != NULL) {
+        freeMinHashScratch(worker->similar);
+    }
+    freeFactorScratch(worker->factors);
+    free(worker->visits);
+    free(worker->ratings);
+    free(worker->movies);
+    free(worker->best);
+    free(worker->recommended);
+    free(worker);
+}
+
+static int runAlgorithm(EvalWorker *worker, int algorithm, int user) {
+    EvalContext *context = worker->context;
+    int rec = context->rec;
+    int *movies = worker->movies;
+    Rng rng;
+    rngSeed(&rng, userSeed(context->seed, user));
+
+    switch (algorithm) {
+    case A_RANDOM:
+        return recommendRandom(user, rec, &rng, movies);
+    case A_HIGH_DEGREE:
+        return recommendHighDegree(user, rec, worker->best, movies);
+    case A_SIMILAR_USER: {
+        int similarUser = worker->similar != NULL ? findSimilarUserApprox(user, worker->similar) : findMostSimilarUser(user);
+        return similarUser != -1 ? recommendFromSimilarUser(user, similarUser, rec, movies) : 0;
+    }
+    case A_NEAREST:
+        return recommendNearestMovies(user, rec, worker->scratch, movies);
+    case A_ITEM:
+        return recommendSimilarItems(itemNeighbors, ratingMatrix, user, rec, worker->items, movies);
+    case A_MF:
+        return recommendFactors(factorModel, ratingMatrix, user, rec, worker->factors, movies);
+    case A_GENRE: {
+        int favoriteGenre, maxCount;
+        find_favorite_genre(user_genre_count[user - 1], &favoriteGenre, &maxCount);
+        return favoriteGenre != -1 ? recommend_movies(user - 1, favoriteGenre, rec, movies, worker->ratings) : 0;
+    }
+    case A_WALK: {
+        WalkConfig walk = {context->steps, 0.15, 1, userSeed(context->seed, user)};
+        return random_walk_recommendation(user - 1, &walk, rec, worker->visits, worker->best, movies);
+    }
+    case A_TRENDING: {
+        TrendQuery query = {0, 0, 1};
+        for (long i = ratingMatrix->rowOffsets[user - 1]; i < ratingMatrix->rowEnds[user - 1]; i++) {
+            if (ratingMatrix->rowTimes[i] > query.to) {
+                query.to = ratingMatrix->rowTimes[i];
+            }
+        }
+        return recommendTrending(trendIndex, ratingMatrix, user, rec, &query, worker->best, movies);
+    }
+    }
+    return 0;
+}
+
+static int containsMovie(const int *sorted, long count, int movie) {
+    long low = 0, high = count;
+    while (low < high) {
+        long mid = (low + high) >> 1;
+        if (sorted[mid] < movie) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < count && sorted[low] == movie;
+}
+
+// Sonuç listesini kalite toplamlarına ve sağlama toplamına katar
+static void scoreList(EvalWorker *worker, int algorithm, int user, const int *movies, int count) {
+    EvalContext *context = worker->context;
+    EvalTotals *total = &worker->totals[algorithm];
+    unsigned char *recommended = worker->recommended + (long)algorithm * numMovies;
+
+    unsigned long long digest = userSeed(0, user) + (unsigned long long)count;
+    for (int i = 0; i < count; i++) {
+        digest ^= (unsigned long long)movies[i] + 0x9E3779B97F4A7C15ULL + (digest << 6) + (digest >> 2);
+        recommended[movies[i] - 1] = 1;
+    }
+    total->checksum += digest;
+
+    const int *relevant = context->testMovies + context->testOffsets[user - 1];
+    long relevantCount = context->testOffsets[user] - context->testOffsets[user - 1];
+    if (relevantCount == 0) {
+        return;
+    }
+    int hits = 0;
+    double dcg = 0, ideal = 0;
+    for (int i = 0; i < count; i++) {
+        if (containsMovie(relevant, relevantCount, movies[i])) {
+            hits++;
+            dcg += 1.0 / log2(i + 2.0);
+        }
+    }
+    for (int i = 0; i < context->rec && i < relevantCount; i++) {
+        ideal += 1.0 / log2(i + 2.0);
+    }
+    total->users++;
+    total->precision += (double)hits / context->rec;
+    total->recall += (double)hits / relevantCount;
+    total->ndcg += dcg / ideal;
+}
+
+static void evalProcessUser(int user, void *ctx, void *threadState, BatchBuffer *out) {
+    EvalWorker *worker = (EvalWorker *)threadState;
+    (void)ctx;
+    for (int a = 0; a < A_COUNT; a++) {
+        long start = nowNanos();
+        int count = runAlgorithm(worker, a, user);
+        worker->totals[a].nanos += nowNanos() - start;
+        worker->totals[a].calls++;
+        batchWriteList(out, user, algorithmNames[a], worker->movies, count);
+        scoreList(worker, a, user, worker->movies, count);
+    }
+}
+
+// Sıralama: kullanıcı, zaman damgası, film, dosyadaki sıra (sonuç girdiden başka bir şeye bağlı değil)
+static const Rating *sortItems;
+
+static int compareByTime(const void *a, const void *b) {
+    const Rating *x = &sortItems[*(const long *)a];
+    const Rating *y = &sortItems[*(const long *)b];
+    if (x->user != y->user) {
+        return x->user < y->user ? -1 : 1;
+    }
+    if (x->timestamp != y->timestamp) {
+        return x->timestamp < y->timestamp ? -1 : 1;
+    }
+    if (x->movie != y->movie) {
+        return x->movie < y->movie ? -1 : 1;
+    }
+    return (*(const long *)a > *(const long *)b) - (*(const long *)a < *(const long *)b);
+}
+
+static int compareInt(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[]) {
+    const char *ratingsFile = "u.data";
+    const char *itemsFile = "u.item";
+    BatchConfig batchConfig = {1, 0, 0, "degerlendirme.tsv"};
+    double testFraction = 0.2;
+    int threshold = 4;
+    int rec = 10;
+    long steps = 20000;
+    unsigned long long seed = 42;
+    int lshBands = 0;
+    int lshRows = MINHASH_ROWS;
+    double halfLifeDays = TREND_HALF_LIFE_DAYS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            ratingsFile = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            itemsFile = argv[++i];
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            rec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            testFraction = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            threshold = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            batchConfig.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            steps = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            batchConfig.outputFile = argv[++i];
+        } else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) {
+            if (parseMinHashShape(argv[++i], &lshBands, &lshRows) != 0) {
+                printf("Gecersiz LSH boyutu: %s (ornek: 16 ya da 16x4)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            halfLifeDays = atof(argv[++i]);
+            if (halfLifeDays <= 0) {
+                printf("Gecersiz yari omur: %s (gun)\n", argv[i]);
+                return 1;
+            }
+        } else {
+            printf("Kullanim: %s [-f puanlar] [-i filmler] [-k oneri] [-p oran] [-e esik] [-t thread] [-s tohum] [-w adim] [-L bant[xsatir]] [-T gun] [-o oneriler.tsv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rec < 1 || testFraction <= 0 || testFraction >= 1) {
+        printf("Gecersiz oneri sayisi ya da test orani.\n");
+        return 1;
+    }
+
+    long prepareStart = nowNanos();
+    RatingSet all;
+    if (loadRatings(ratingsFile, 0, &all) != 0) {
+        printf("Dosya acilamadi: %s\n", ratingsFile);
+        return 1;
+    }
+    if (all.maxUser < 1 || all.maxMovie < 1) {
+        printf("Dosyada puan yok: %s\n", ratingsFile);
+        return 1;
+    }
+
+    // Her kullanıcının en yeni puanları teste ayrılır
+    long *order = (long *)malloc(all.count * sizeof(long));
+    for (long i = 0; i < all.count; i++) {
+        order[i] = i;
+    }
+    sortItems = all.items;
+    qsort(order, all.count, sizeof(long), compareByTime);
+    unsigned char *heldOut = (unsigned char *)calloc(all.count, 1);
+    long *testOffsets = (long *)calloc(all.maxUser + 1, sizeof(long));
+    int *testMovies = (int *)malloc(all.count * sizeof(int));
+    long testCount = 0, relevantCount = 0;
+    for (long first = 0; first < all.count;) {
+        int user = all.items[order[first]].user;
+        long last = first;
+        while (last < all.count && all.items[order[last]].user == user) {
+            last++;
+        }
+        long length = last - first;
+        long held = (long)(length * testFraction);
+        if (held < 1) {
+            held = 1;
+        }
+        if (held > length - 1) {
+            held = length - 1;  //eğitimde en az bir puan kalır
+        }
+        long start = relevantCount;
+        for (long j = last - held; j < last; j++) {
+            const Rating *r = &all.items[order[j]];
+            heldOut[order[j]] = 1;
+            testCount++;
+            if (r->rating >= threshold) {
+                testMovies[relevantCount++] = r->movie;
+            }
+        }
+        qsort(testMovies + start, relevantCount - start, sizeof(int), compareInt);
+        testOffsets[user] = relevantCount - start;  //önce sayılar, aşağıda öneklere çevrilir
+        first = last;
+    }
+    for (int u = 1; u <= all.maxUser; u++) {
+        testOffsets[u] += testOffsets[u - 1];
+    }
+
+    RatingSet train = all;
+    train.items = (Rating *)malloc(all.count * sizeof(Rating));
+    train.count = 0;
+    for (long i = 0; i < all.count; i++) {
+        if (!heldOut[i]) {
+            train.items[train.count++] = all.items[i];
+        }
+    }
+    free(heldOut);
+    free(order);
+
+    // İki programın verisi eğitim puanlarından kurulur (boyutlar tüm veriyle aynı)
+    loadRatingStoreFromSet(&train);
+    share_rating_data(ratingMatrix);
+    build_movie_genres(itemsFile);
+    if (lshBands > 0) {
+        userIndex = buildMinHashIndex(ratingMatrix, lshBands, lshRows, MINHASH_SEED, batchConfig.threads);
+    }
+    MfConfig mfConfig = {MF_SGD, 20, 1, 0.02, 0.05, seed};
+    factorModel = trainFactorModel(ratingMatrix, &mfConfig, NULL);
+    trendIndex = buildTrendIndex(ratingMatrix, halfLifeDays);
+    long prepareNanos = nowNanos() - prepareStart;
+
+    if (rec > numMovies) {
+        rec = numMovies;
+    }
+    EvalContext context;
+    memset(&context, 0, sizeof(context));
+    context.rec = rec;
+    context.steps = steps;
+    context.seed = seed;
+    context.testOffsets = testOffsets;
+    context.testMovies = testMovies;
+    pthread_mutex_init(&context.lock, NULL);
+    context.recommended = (unsigned char *)calloc((long)A_COUNT * numMovies, 1);
+
+    batchConfig.lastUser = numUsers;
+    BatchHooks hooks = {evalThreadInit, evalProcessUser, evalThreadFree};
+    long evalStart = nowNanos();
+    if (runBatch(&batchConfig, &hooks, &context) != 0) {
+        return 1;
+    }
+    long evalNanos = nowNanos() - evalStart;
+    int threads = batchConfig.threads > 0 ? batchConfig.threads : defaultThreadCount();
+
+    printf("%s: %d kullanici, %d film; egitim %ld puan, test %ld puan (%ld ilgili, puan >= %d), k = %d\n",
+           ratingsFile, numUsers, numMovies, train.count, testCount, relevantCount, threshold, rec);
+    printf("%-14s %12s %12s %9s %9s %12s %10s  %s\n", "algoritma", "precision@k", "recall@k", "ndcg@k",
+           "kapsama", "cagri/s", "ort_us", "saglama");
+    for (int a = 0; a < A_COUNT; a++) {
+        const EvalTotals *total = &context.totals[a];
+        const unsigned char *recommended = context.recommended + (long)a * numMovies;
+        int covered = 0;
+        for (int m = 0; m < numMovies; m++) {
+            covered += recommended[m];
+        }
+        double users = total->users > 0 ? total->users : 1;
+        printf("%-14s %12.4f %12.4f %9.4f %9.4f %12.1f %10.2f  %016llx\n", algorithmNames[a],
+               total->precision / users, total->recall / users, total->ndcg / users, (double)covered / numMovies,
+               total->nanos > 0 ? total->calls / (total->nanos / 1e9) : 0.0,
+               total->calls > 0 ? total->nanos / 1e3 / total->calls : 0.0, total->checksum);
+    }
+    printf("hazirlik %.3f s, degerlendirme %.3f s (%d is parcacigi, saniyede %.1f kullanici), degerlendirilen %d kullanici\n",
+           prepareNanos / 1e9, evalNanos / 1e9, threads, numUsers / (evalNanos / 1e9), context.totals[0].users);
+    printf("Oneriler %s dosyasina yazildi.\n", batchConfig.outputFile);
+    metricsDump(stderr);
+
+    pthread_mutex_destroy(&context.lock);
+    free(context.recommended);
+    free(testOffsets);
+    free(testMovies);
+    free(train.items);
+    freeRatingSet(&all);
+    free_bipartite_matrix();
+    freeRatingStore();
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "loader.h"
+#include "bitmatrix.h"
+#include "snapshot.h"
+#include "itemsim.h"
+
+// u.data ve u.item'dan tüm veri yapılarını bir kez kurup ikili snapshot dosyasına yazar.
+// Kullanım: ./derle [u.data] [u.item] [veri.snap]
+// oneri1 ve oneri2 -S veri.snap ile başlatılınca metin dosyalarını okumadan bu dosyayı kullanır.
+// Film-film benzerlik tablosu da burada (tüm çekirdeklerle) bir kez hesaplanıp yazılır.
+int main(int argc, char *argv[]) {
+    const char *ratingsFile = argc > 1 ? argv[1] : "u.data";
+    const char *itemsFile = argc > 2 ? argv[2] : "u.item";
+    const char *outputFile = argc > 3 ? argv[3] : "veri.snap";
+
+    RatingSet set;
+    if (loadRatings(ratingsFile, 0, &set) != 0) {
+        printf("Dosya acilamadi: %s\n", ratingsFile);
+        return 1;
+    }
+    MovieGenres genres;
+    if (loadMovieGenres(itemsFile, &genres) != 0) {
+        printf("Dosya acilamadi: %s\n", itemsFile);
+        return 1;
+    }
+
+    int users = set.maxUser;
+    int movies = set.maxMovie > genres.maxMovie ? set.maxMovie : genres.maxMovie;
+
+    RatingMatrix *matrix = buildRatingMatrix(&set, users, movies);
+    ItemNeighbors *items = buildItemNeighbors(matrix, ITEM_NEIGHBORS, 0);
+
+    int result = writeSnapshot(outputFile, ratingsFile, itemsFile, set.count, matrix, &genres, items);
+    if (result == 0) {
+        printf("%s yazildi: %d kullanici, %d film, %ld puan (%ld farkli), film basina %d komsu\n",
+               outputFile, users, movies, set.count, matrix->nonZeros, items->neighbors);
+    }
+
+    freeItemNeighbors(items);
+
+    freeRatingMatrix(matrix);
+    freeMovieGenres(&genres);
+    freeRatingSet(&set);
+    return result == 0 ? 0 : 1;
+}
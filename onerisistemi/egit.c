@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "loader.h"
+#include "bitmatrix.h"
+#include "mf.h"
+
+// Gizil faktör modelini (bkz. mf.h) puan dosyasından eğitip ikili model dosyasına yazar.
+// Kullanım: ./egit [-f puanlar] [-m sgd|als] [-e tur] [-a ogrenme] [-r duzenleme] [-t thread] [-s tohum] [-o model.mf]
+// Her turun süresi ve eğitim hatası (RMSE) yazılır. oneri1, sunucu ve olcum -M model.mf ile modeli
+// açıp "mf" önerisini verir, kendileri eğitim yapmaz.
+int main(int argc, char *argv[]) {
+    const char *ratingsFile = "u.data";
+    const char *outputFile = "model.mf";
+    MfConfig config = {MF_SGD, 20, 0, 0.02, 0.05, 42};
+    int epochsGiven = 0;
+    int regularizationGiven = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            ratingsFile = argv[++i];
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            const char *method = argv[++i];
+            if (strcmp(method, "sgd") == 0) {
+                config.method = MF_SGD;
+            } else if (strcmp(method, "als") == 0) {
+                config.method = MF_ALS;
+            } else {
+                printf("Bilinmeyen egitim yontemi: %s (sgd, als)\n", method);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            config.epochs = atoi(argv[++i]);
+            epochsGiven = 1;
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            config.learningRate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            config.regularization = atof(argv[++i]);
+            regularizationGiven = 1;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else {
+            printf("Kullanim: %s [-f puanlar] [-m sgd|als] [-e tur] [-a ogrenme] [-r duzenleme] [-t thread] [-s tohum] [-o model.mf]\n", argv[0]);
+            return 1;
+        }
+    }
+    // als'de düzenleme puan sayısıyla çarpılır, sgd'ninkinden büyük seçilir; her turu daha pahalı ama az turda yakınsar
+    if (config.method == MF_ALS && !regularizationGiven) {
+        config.regularization = 0.1;
+    }
+    if (config.method == MF_ALS && !epochsGiven) {
+        config.epochs = 10;
+    }
+    if (config.epochs < 1 || config.regularization < 0 || config.learningRate <= 0) {
+        printf("Gecersiz egitim ayari.\n");
+        return 1;
+    }
+
+    RatingSet set;
+    if (loadRatings(ratingsFile, 0, &set) != 0) {
+        printf("Dosya acilamadi: %s\n", ratingsFile);
+        return 1;
+    }
+    RatingMatrix *matrix = buildRatingMatrix(&set, set.maxUser, set.maxMovie);
+    freeRatingSet(&set);
+
+    printf("%s: %d kullanici, %d film, %ld puan, %d faktor, %s (%s)\n", ratingsFile, matrix->users, matrix->movies,
+           matrix->nonZeros, MF_FACTORS, config.method == MF_ALS ? "als" : "sgd",
+           mfKernelUsesAvx2() ? "avx2" : "skaler");
+    MfEpoch *epochs = (MfEpoch *)malloc(config.epochs * sizeof(MfEpoch));
+    FactorModel *model = trainFactorModel(matrix, &config, epochs);
+    double total = 0;
+    for (int e = 0; e < config.epochs; e++) {
+        printf("tur %2d: %.3f s, egitim rmse %.4f\n", e + 1, epochs[e].seconds, epochs[e].rmse);
+        total += epochs[e].seconds;
+    }
+
+    int result = writeFactorModel(outputFile, model);
+    if (result == 0) {
+        printf("%s yazildi: %d tur %.3f s (tur basina %.3f s)\n", outputFile, config.epochs, total, total / config.epochs);
+    }
+    free(epochs);
+    freeFactorModel(model);
+    freeRatingMatrix(matrix);
+    return result == 0 ? 0 : 1;
+}
@@ -0,0 +1,448 @@
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+
+#include "graph.h"
+#include "metrics.h"
+
+DijkstraMode dijkstraMode = DIJKSTRA_BUCKET;
+
+// Kenar ağırlığı puandan tabloyla bulunur: 1.0 / rating'in float hali ve WEIGHT_SCALE / rating.
+// Ağırlık 1/rating çünkü en yakın film önerisinde en yüksek puanlı kenarlardan gidilsin istiyorum
+const float ratingWeight[RATING_LEVELS + 1] = {0, 1.0 / 1, 1.0 / 2, 1.0 / 3, 1.0 / 4, 1.0 / 5};
+const unsigned char ratingWeightUnits[RATING_LEVELS + 1] = {0, 60, 30, 20, 15, 12};
+
+// Her puan iki yönlü bir kenardır
+static long edgeCount(const RatingMatrix *matrix) {
+    return 2 * matrix->nonZeros;
+}
+
+// Dijkstra çalışma alanını grafiğin boyutuna göre bir kez ayır
+// Yığın ve kova kayıtları için E + 1 yer yeterli, her kenar en fazla bir kayıt ekler
+DijkstraScratch *createDijkstraScratch(const RatingMatrix *matrix) {
+    int vertices = graphVertices(matrix);
+    DijkstraScratch *scratch = (DijkstraScratch *)malloc(sizeof(DijkstraScratch));
+    scratch->distances = (float *)malloc(vertices * sizeof(float));
+    scratch->visited = (bool *)malloc(vertices * sizeof(bool));
+    scratch->units = (int *)malloc(vertices * sizeof(int));
+    scratch->bucketHead = (int *)malloc((MAX_WEIGHT_UNITS + 1) * sizeof(int));
+    scratch->entryVertex = NULL;
+    scratch->entryNext = NULL;
+    scratch->heap = NULL;
+    scratch->candidates = (int *)malloc(vertices * sizeof(int));
+    scratch->edgeCapacity = edgeCount(matrix) + 1;
+    scratch->visitedCount = 0;
+    scratch->reachUnits = NULL;
+    scratch->reachState = NULL;
+    scratch->touched = NULL;
+    scratch->touchedCount = 0;
+    scratch->pendingMovies = (int *)malloc((MAX_WEIGHT_UNITS + 1) * sizeof(int));
+    return scratch;
+}
+
+void freeDijkstraScratch(DijkstraScratch *scratch) {
+    free(scratch->distances);
+    free(scratch->visited);
+    free(scratch->units);
+    free(scratch->bucketHead);
+    free(scratch->entryVertex);
+    free(scratch->entryNext);
+    free(scratch->heap);
+    free(scratch->candidates);
+    free(scratch->reachUnits);
+    free(scratch->reachState);
+    free(scratch->touched);
+    free(scratch->pendingMovies);
+    free(scratch);
+}
+
+// Matrise puan eklendiyse yığın ve kova kayıtları eski boyda kalmasın; bir sonraki çağrıda yeniden ayrılırlar
+static void reserveEntries(const RatingMatrix *matrix, DijkstraScratch *scratch) {
+    if (scratch->edgeCapacity < edgeCount(matrix) + 1) {
+        free(scratch->heap);
+        free(scratch->entryVertex);
+        free(scratch->entryNext);
+        scratch->heap = NULL;
+        scratch->entryVertex = NULL;
+        scratch->entryNext = NULL;
+        scratch->edgeCapacity = (edgeCount(matrix) + 1) * 2;
+    }
+}
+
+// Dijkstra algoritması
+// Seçilen yönteme göre ilgili sürümü çağırır. Üç sürüm de aynı mesafeleri verir.
+void dijkstra(const RatingMatrix *matrix, int src, float *distances, DijkstraScratch *scratch) {
+    METRICS_BEGIN(PHASE_DIJKSTRA);
+    switch (dijkstraMode) {
+    case DIJKSTRA_SCAN:
+        scratch->visitedCount = dijkstraScan(matrix, src, distances, scratch);
+        break;
+    case DIJKSTRA_HEAP:
+        scratch->visitedCount = dijkstraHeap(matrix, src, distances, scratch);
+        break;
+    default:
+        scratch->visitedCount = dijkstraBucket(matrix, src, distances, scratch);
+        break;
+    }
+    METRICS_ADD(METRIC_NODES_SETTLED, scratch->visitedCount);
+    METRICS_END(PHASE_DIJKSTRA);
+}
+
+// Her adımda tüm düğümleri tarayıp en yakını seçen ilk sürüm, O(V^2)
+int dijkstraScan(const RatingMatrix *matrix, int src, float *distances, DijkstraScratch *scratch) {
+    int V = graphVertices(matrix);
+    bool *visited = scratch->visited;  //düğümün ziyaret edilip edilmediğini tutuyor
+    int visitedCount = 0; 
+
+    for (int i = 0; i < V; i++) {
+        distances[i] = FLT_MAX;  //en başta hepsi kaynak düğüme sonsuz uzaklıkta
+        visited[i] = false;
+    }
+    distances[src] = 0.0; //kaynak düğüm 
+
+    for (int count = 0; count < V; count++) {
+        float minDist = FLT_MAX; 
+        int minIndex = -1;
+        for (int v = 0; v < V; v++) {
+            if (!visited[v] && distances[v] < minDist) {
+                minDist = distances[v];
+                minIndex = v;
+            }
+        }
+
+        if (minIndex == -1) {
+            break;
+        }
+
+        visited[minIndex] = true;  // kaynağa en yakın olan düğüm bulunur.
+        visitedCount++;
+        const int *keys;
+        const unsigned char *ratings;
+        int base;
+        int degree = vertexEdges(matrix, minIndex, &keys, &ratings, &base);
+        METRICS_ADD(METRIC_EDGES_RELAXED, degree);
+
+        for (int e = 0; e < degree; e++) {  //Seçilen düğümün komşuları dolaşılır.
+            int dest = keys[e] + base;
+            float weight = ratingWeight[ratings[e]];
+            if (!visited[dest] && distances[minIndex] + weight < distances[dest]) {
+                distances[dest] = distances[minIndex] + weight;
+            }  //kaynak düğümden diğer düğümlere olan mesafeler distances içinde depolanır
+        }
+    } //kaynak düğümden (bizim öneri istediğimiz kullanıcı) ulaşılabilecek her yere ulaşıp onların mesafesini bulana kadar devam eder
+
+    return visitedCount;
+}
+
+// Önce mesafeye, eşitse düğüm numarasına bakılır; tarama sürümü de eşitlikte küçük numaralıyı seçiyor
+static bool heapLess(HeapEntry a, HeapEntry b) {
+    return a.dist < b.dist || (a.dist == b.dist && a.vertex < b.vertex);
+}
+
+// İkili yığın ile dijkstra, O(E log V)
+// Bir düğümün mesafesi azalınca yığına yeni bir kayıt eklenir, eski kayıt çıkınca atlanır (lazy deletion).
+// Her kenar en fazla bir kayıt eklediği için yığın E + 1 ile sınırlıdır.
+int dijkstraHeap(const RatingMatrix *matrix, int src, float *distances, DijkstraScratch *scratch) {
+    int V = graphVertices(matrix);
+    bool *visited = scratch->visited;
+    reserveEntries(matrix, scratch);
+    if (scratch->heap == NULL) {
+        scratch->heap = (HeapEntry *)malloc(scratch->edgeCapacity * sizeof(HeapEntry));
+    }
+    HeapEntry *heap = scratch->heap;
+    int heapSize = 0;
+    int visitedCount = 0;
+
+    for (int i = 0; i < V; i++) {
+        distances[i] = FLT_MAX;
+        visited[i] = false;
+    }
+    distances[src] = 0.0;
+    heap[heapSize++] = (HeapEntry){0.0f, src};
+
+    while (heapSize > 0) {
+        HeapEntry top = heap[0];
+
+        // En üstteki eleman çıkarılır, son eleman köke konup aşağı doğru yerleştirilir
+        HeapEntry last = heap[--heapSize];
+        int i = 0;
+        while (2 * i + 1 < heapSize) {
+            int child = 2 * i + 1;
+            if (child + 1 < heapSize && heapLess(heap[child + 1], heap[child])) {
+                child++;
+            }
+            if (!heapLess(heap[child], last)) {
+                break;
+            }
+            heap[i] = heap[child];
+            i = child;
+        }
+        heap[i] = last;
+
+        int u = top.vertex;
+        if (visited[u]) {
+            continue; //bu düğüm daha kısa bir mesafeyle zaten ziyaret edildi
+        }
+        visited[u] = true;
+        visitedCount++;
+        const int *keys;
+        const unsigned char *ratings;
+        int base;
+        int degree = vertexEdges(matrix, u, &keys, &ratings, &base);
+        METRICS_ADD(METRIC_EDGES_RELAXED, degree);
+
+        for (int e = 0; e < degree; e++) {
+            int dest = keys[e] + base;
+            float newDist = distances[u] + ratingWeight[ratings[e]];
+            if (!visited[dest] && newDist < distances[dest]) {
+                distances[dest] = newDist;
+
+                // Yeni kayıt sona eklenir ve yukarı doğru yerleştirilir
+                HeapEntry entry = {newDist, dest};
+                int j = heapSize++;
+                while (j > 0 && heapLess(entry, heap[(j - 1) / 2])) {
+                    heap[j] = heap[(j - 1) / 2];
+                    j = (j - 1) / 2;
+                }
+                heap[j] = entry;
+            }
+        }
+    }
+
+    return visitedCount;
+}
+
+// Kova kuyruğu (Dial) ile dijkstra, O(E + V)
+// Tam sayı mesafe (weightUnits toplamı) kovayı belirler. En büyük ağırlık MAX_WEIGHT_UNITS olduğu için
+// aynı anda dolu olan kovalar bir pencereye sığar, MAX_WEIGHT_UNITS + 1 kova dairesel olarak kullanılır.
+// Float mesafe, tarama sürümündeki gibi distances[u] + weight ile ayrıca tutulur; bir kovadaki düğümlerin
+// tüm öncülleri daha önceki kovalarda olduğu için sonuç tarama sürümüyle bit bit aynıdır.
+int dijkstraBucket(const RatingMatrix *matrix, int src, float *distances, DijkstraScratch *scratch) {
+    int V = graphVertices(matrix);
+    int numBuckets = MAX_WEIGHT_UNITS + 1;
+    bool *visited = scratch->visited;
+    int *units = scratch->units;      //tam sayı mesafe
+    int *bucketHead = scratch->bucketHead;
+    reserveEntries(matrix, scratch);
+    if (scratch->entryVertex == NULL) {
+        scratch->entryVertex = (int *)malloc(scratch->edgeCapacity * sizeof(int));
+        scratch->entryNext = (int *)malloc(scratch->edgeCapacity * sizeof(int));
+    }
+    int *entryVertex = scratch->entryVertex; //kovalardaki kayıtlar
+    int *entryNext = scratch->entryNext;
+    int entryCount = 0;
+    int pending = 0; //kovalarda bekleyen kayıt sayısı
+    int visitedCount = 0;
+
+    for (int i = 0; i < V; i++) {
+        distances[i] = FLT_MAX;
+        units[i] = INT_MAX;
+        visited[i] = false;
+    }
+    for (int b = 0; b < numBuckets; b++) {
+        bucketHead[b] = -1;
+    }
+    distances[src] = 0.0;
+    units[src] = 0;
+    entryVertex[entryCount] = src;
+    entryNext[entryCount] = -1;
+    bucketHead[0] = entryCount++;
+    pending++;
+
+    for (int current = 0; pending > 0; current++) {
+        int b = current % numBuckets;
+        while (bucketHead[b] != -1) {
+            int entry = bucketHead[b];
+            bucketHead[b] = entryNext[entry];
+            pending--;
+
+            int u = entryVertex[entry];
+            if (visited[u] || units[u] != current) {
+                continue; //eski kayıt
+            }
+            visited[u] = true;
+            visitedCount++;
+            const int *keys;
+            const unsigned char *ratings;
+            int base;
+            int degree = vertexEdges(matrix, u, &keys, &ratings, &base);
+            METRICS_ADD(METRIC_EDGES_RELAXED, degree);
+
+            for (int e = 0; e < degree; e++) {
+                int dest = keys[e] + base;
+                if (visited[dest]) {
+                    continue;
+                }
+                float newDist = distances[u] + ratingWeight[ratings[e]];
+                if (newDist < distances[dest]) {
+                    distances[dest] = newDist;
+                }
+                int newUnits = current + ratingWeightUnits[ratings[e]];
+                if (newUnits < units[dest]) {
+                    units[dest] = newUnits;
+                    int nb = newUnits % numBuckets;
+                    entryVertex[entryCount] = dest;
+                    entryNext[entryCount] = bucketHead[nb];
+                    bucketHead[nb] = entryCount++;
+                    pending++;
+                }
+            }
+        }
+    }
+
+    return visitedCount;
+}
+
+static int compareVertices(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// Sınırlı kova kuyruğu: dijkstraBucket ile aynı kovalar, ama
+//  - diziler her çağrıda baştan doldurulmaz, sadece önceki çağrının dokunduğu düğümler (touched) sıfırlanır
+//  - bir mesafe katmanı (aynı tam sayı mesafedeki düğümler) bitince k izlenmemiş film bulunduysa durulur
+//  - kuyruktaki izlenmemiş filmlerin sayısı kova kova tutulur; yerleşmiş ve bekleyen filmlerden k.sının mesafesi
+//    (bound) sonucun üst sınırıdır. Ondan uzağa giden kenarlar kuyruğa girmez, komşuları ondan uzak kalacak
+//    düğümlerin kenarları hiç gezilmez. Yoğun grafikte gezilen kenarların çoğu bunlardır.
+// Katmanlar artan mesafeyle bittiği için bulunan filmler zaten mesafeye göre sıralıdır, sadece her katmanın
+// içi düğüm numarasına göre sıralanır.
+int nearestUnseenMovies(const RatingMatrix *matrix, int src, int k, DijkstraScratch *scratch, int *out) {
+    if (k <= 0) {
+        return 0;  //scratch'e dokunulmaz, önceki çağrının touched listesi geçerli kalır
+    }
+    METRICS_BEGIN(PHASE_DIJKSTRA);
+    int V = graphVertices(matrix);
+    int firstMovie = matrix->users;
+    int numBuckets = MAX_WEIGHT_UNITS + 1;
+    if (scratch->reachUnits == NULL) {
+        scratch->reachUnits = (int *)malloc(V * sizeof(int));
+        scratch->reachState = (unsigned char *)calloc(V, 1);
+        scratch->touched = (int *)malloc(V * sizeof(int));
+        for (int i = 0; i < V; i++) {
+            scratch->reachUnits[i] = INT_MAX;
+        }
+        scratch->touchedCount = 0;
+    }
+    int *units = scratch->reachUnits;
+    unsigned char *state = scratch->reachState;
+    int *touched = scratch->touched;
+    for (int i = 0; i < scratch->touchedCount; i++) {
+        units[touched[i]] = INT_MAX;
+        state[touched[i]] = 0;
+    }
+    int touchedCount = 0;
+
+    reserveEntries(matrix, scratch);
+    if (scratch->entryVertex == NULL) {
+        scratch->entryVertex = (int *)malloc(scratch->edgeCapacity * sizeof(int));
+        scratch->entryNext = (int *)malloc(scratch->edgeCapacity * sizeof(int));
+    }
+    int *entryVertex = scratch->entryVertex;
+    int *entryNext = scratch->entryNext;
+    int *bucketHead = scratch->bucketHead;
+    int *pendingMovies = scratch->pendingMovies;
+    int *found = scratch->candidates;
+    for (int b = 0; b < numBuckets; b++) {
+        bucketHead[b] = -1;
+        pendingMovies[b] = 0;
+    }
+
+    int watchedCount;
+    const int *watched = userRow(matrix, src, &watchedCount);
+    for (int i = 0; i < watchedCount; i++) {
+        state[firstMovie + watched[i]] |= REACH_SEEN;  //izlenen filmler; kaynaktan hemen gevşetildikleri için touched'a girerler
+    }
+    units[src] = 0;
+    touched[touchedCount++] = src;
+    entryVertex[0] = src;
+    entryNext[0] = -1;
+    bucketHead[0] = 0;
+    int entryCount = 1;
+    int pending = 1;
+    int foundCount = 0;
+    int settled = 0;
+
+    for (int current = 0; pending > 0; current++) {
+        int b = current % numBuckets;
+        if (bucketHead[b] == -1) {
+            continue;
+        }
+        if (foundCount >= k) {
+            break;  //k film bulundu ve son katmanları bitti
+        }
+        // Bekleyen kayıtlar [current, current + MAX_WEIGHT_UNITS] aralığındadır
+        int bound = INT_MAX;
+        int reached = foundCount;
+        for (int t = current; t <= current + MAX_WEIGHT_UNITS; t++) {
+            reached += pendingMovies[t % numBuckets];
+            if (reached >= k) {
+                bound = t;
+                break;
+            }
+        }
+        int layerStart = foundCount;
+        while (bucketHead[b] != -1) {
+            int entry = bucketHead[b];
+            bucketHead[b] = entryNext[entry];
+            pending--;
+
+            int u = entryVertex[entry];
+            if ((state[u] & REACH_SETTLED) || units[u] != current) {
+                continue; //eski kayıt
+            }
+            state[u] |= REACH_SETTLED;
+            settled++;
+            int unseenMovie = u >= firstMovie && !(state[u] & REACH_SEEN);
+            if (unseenMovie) {
+                found[foundCount++] = u;
+                pendingMovies[b]--;
+            }
+            if (current + MIN_WEIGHT_UNITS > bound) {
+                continue;  //komşuları sonuca giremez
+            }
+            const int *keys;
+            const unsigned char *ratings;
+            int base;
+            int degree = vertexEdges(matrix, u, &keys, &ratings, &base);
+            METRICS_ADD(METRIC_EDGES_RELAXED, degree);
+
+            for (int e = 0; e < degree; e++) {
+                int dest = keys[e] + base;
+                if (state[dest] & REACH_SETTLED) {
+                    continue;
+                }
+                int newUnits = current + ratingWeightUnits[ratings[e]];
+                if (newUnits < units[dest] && newUnits <= bound) {
+                    if (units[dest] == INT_MAX) {
+                        touched[touchedCount++] = dest;
+                    } else if (dest >= firstMovie && !(state[dest] & REACH_SEEN)) {
+                        pendingMovies[units[dest] % numBuckets]--;
+                    }
+                    if (dest >= firstMovie && !(state[dest] & REACH_SEEN)) {
+                        pendingMovies[newUnits % numBuckets]++;
+                    }
+                    units[dest] = newUnits;
+                    int nb = newUnits % numBuckets;
+                    entryVertex[entryCount] = dest;
+                    entryNext[entryCount] = bucketHead[nb];
+                    bucketHead[nb] = entryCount++;
+                    pending++;
+                }
+            }
+        }
+        if (foundCount - layerStart > 1) {
+            qsort(found + layerStart, foundCount - layerStart, sizeof(int), compareVertices);
+        }
+    }
+    // Kuyrukta kalan kayıtların kovaları bir sonraki çağrıda baştan -1 yapılır
+
+    scratch->touchedCount = touchedCount;
+    scratch->visitedCount = settled;
+    int count = foundCount < k ? foundCount : k;
+    for (int i = 0; i < count; i++) {
+        out[i] = found[i];
+    }
+    METRICS_ADD(METRIC_NODES_SETTLED, settled);
+    METRICS_END(PHASE_DIJKSTRA);
+    return count;
+}
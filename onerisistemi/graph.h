@@ -0,0 +1,103 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <stdbool.h>
+
+#include "bitmatrix.h"
+
+// Kullanıcı-film iki parçalı (bipartite) grafiği ve üzerinde en kısa yol (dijkstra) hesapları.
+// Kullanıcı u (1 tabanlı) u - 1 numaralı düğüm, film m ise kullanıcı sayısı + m - 1 numaralı düğümdür.
+//
+// Grafiğin ayrı bir kopyası yoktur, kenarlar puan deposunun (bitmatrix.h) kendisidir: kullanıcı düğümünün
+// kenarları satırındaki filmler, film düğümünün kenarları sütunundaki kullanıcılardır ve ağırlık puandan
+// hesaplanır. Bir düğümün komşuları yine bellekte yan yana durur (CSR); canlı güncellemede matrise eklenen
+// puan grafiğe de eklenmiş olur.
+
+// Ağırlıklar hep 1/rating (rating 1..5) olduğu için 60 (1..5'in EKOK'u) ile çarpınca tam sayı olur:
+// 5 puan -> 12, 4 puan -> 15, 3 puan -> 20, 2 puan -> 30, 1 puan -> 60
+#define WEIGHT_SCALE 60
+#define MAX_WEIGHT_UNITS WEIGHT_SCALE
+#define MIN_WEIGHT_UNITS (WEIGHT_SCALE / 5)
+
+// Puanı r olan kenarın ağırlığı (1/r) ve aynı ağırlığın WEIGHT_SCALE ile çarpılmış tam sayı hali (kova kuyruğu için)
+extern const float ratingWeight[RATING_LEVELS + 1];
+extern const unsigned char ratingWeightUnits[RATING_LEVELS + 1];
+
+static inline int graphVertices(const RatingMatrix *matrix) {
+    return matrix->users + matrix->movies;
+}
+
+// v düğümünün kenarları: i. kenar keys[i] + base numaralı düğüme gider, puanı ratings[i]'dir. Kenar sayısı döner
+static inline int vertexEdges(const RatingMatrix *matrix, int v, const int **keys, const unsigned char **ratings,
+                              int *base) {
+    if (v < matrix->users) {
+        long start = matrix->rowOffsets[v];
+        *keys = matrix->rowMovies + start;
+        *ratings = matrix->rowRatings + start;
+        *base = matrix->users;
+        return (int)(matrix->rowEnds[v] - start);
+    }
+    int movie = v - matrix->users;
+    long start = matrix->colOffsets[movie];
+    *keys = matrix->colUsers + start;
+    *ratings = matrix->colRatings + start;
+    *base = 0;
+    return (int)(matrix->colEnds[movie] - start);
+}
+
+// dijkstra'nın bir sonraki düğümü seçme yöntemi
+typedef enum DijkstraMode {
+    DIJKSTRA_SCAN,   //her adımda tüm düğümleri tarar, O(V^2)
+    DIJKSTRA_HEAP,   //ikili yığın (binary heap), O(E log V)
+    DIJKSTRA_BUCKET  //kova kuyruğu (Dial), ağırlıklar az sayıda tam sayı olduğu için O(E)
+} DijkstraMode;
+
+// Yığındaki bir eleman: düğüm ve o an bilinen mesafesi
+typedef struct HeapEntry {
+    float dist;
+    int vertex;
+} HeapEntry;
+
+// Bir dijkstra çağrısının çalışma alanı. Her iş parçacığı bunu bir kez ayırır ve tekrar tekrar kullanır,
+// böylece her çağrıda malloc/free yapılmaz ve iş parçacıkları birbirinin dizilerine dokunmaz.
+// Kenar sayısı kadar olan diziler (yığın, kova kayıtları) sadece o yöntem ilk kez kullanılınca ayrılır;
+// büyük veride her iş parçacığı kullanmadığı yöntemin yerini de tutmasın diye.
+typedef struct DijkstraScratch {
+    float *distances;
+    bool *visited;
+    int *units;        //kova kuyruğu için tam sayı mesafe
+    int *bucketHead;
+    int *entryVertex;  //kova kayıtları (ilk kova çağrısında ayrılır)
+    int *entryNext;
+    HeapEntry *heap;   //ilk yığın çağrısında ayrılır
+    int *candidates;   //vertices elemanlı, çağıranın aday listesi için (örneğin en yakın filmler)
+    long edgeCapacity; //yığın ve kova kayıtları için ayrılan yer (E + 1, puan eklenirse yeniden ayrılır)
+    int visitedCount;  //son çağrıda ziyaret edilen düğüm sayısı
+    // nearestUnseenMovies'in durumu (ilk çağrısında ayrılır). Diziler hep temiz tutulur: her çağrı başta sadece
+    // bir öncekinin dokunduğu düğümleri geri sıfırlar, böylece iş tüm grafiğe değil gezilen bölgeye orantılıdır.
+    // Çağrıdan sonra dokunulan düğümlerin mesafeleri (reachUnits) bir sonraki çağrıya kadar okunabilir.
+    int *reachUnits;            //tam sayı mesafe (WEIGHT_SCALE ile çarpılmış), dokunulmayanlarda INT_MAX
+    unsigned char *reachState;  //REACH_SETTLED, REACH_SEEN bitleri
+    int *touched;               //son çağrıda mesafesi yazılan düğümler
+    int touchedCount;
+    int *pendingMovies;         //MAX_WEIGHT_UNITS + 1 kova, her kovada bekleyen izlenmemiş film sayısı
+} DijkstraScratch;
+
+#define REACH_SETTLED 1  //mesafesi kesinleşti
+#define REACH_SEEN 2     //kaynağın komşusu (kullanıcının izlediği film)
+
+extern DijkstraMode dijkstraMode; // dijkstra() hangi yöntemi kullanır; olcum sırayla üçünü de ölçer
+
+DijkstraScratch *createDijkstraScratch(const RatingMatrix *matrix);
+void freeDijkstraScratch(DijkstraScratch *scratch);
+void dijkstra(const RatingMatrix *matrix, int src, float *distances, DijkstraScratch *scratch);
+int dijkstraScan(const RatingMatrix *matrix, int src, float *distances, DijkstraScratch *scratch);
+int dijkstraHeap(const RatingMatrix *matrix, int src, float *distances, DijkstraScratch *scratch);
+int dijkstraBucket(const RatingMatrix *matrix, int src, float *distances, DijkstraScratch *scratch);
+// src kullanıcı düğümünden en yakın, src'nin komşusu olmayan (izlenmemiş) k film düğümü. Tüm grafik yerine
+// kova kuyruğuyla sadece k izlenmemiş film yerleşene kadar gezilir; k. filmin mesafesindeki diğer düğümler de
+// bitirilip durulur. Sonuç mesafeye göre artan, eşit mesafede küçük numaralı düğüm önce olacak şekilde out'a
+// yazılır (sonuç rastgelelik içermez), bulunan sayı döner.
+int nearestUnseenMovies(const RatingMatrix *matrix, int src, int k, DijkstraScratch *scratch, int *out);
+
+#endif
@@ -0,0 +1,291 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ingest.h"
+#include "recommend1.h"
+#include "recommend2.h"
+
+static int active = 0;
+static pthread_rwlock_t dataLock;
+static IngestStats totals;
+static IngestListener listener = NULL;
+static void *listenerContext = NULL;
+
+// Bir grupta kenarı değişen düğümler; grup sonunda yürüyüş tabloları bunlar için güncellenir
+static int *dirtyIndex = NULL;          //vertices, düğümün listedeki yeri + 1 (listede değilse 0)
+static int *dirtyList = NULL;
+static unsigned char *dirtyChange = NULL; //INGEST_RATING_ADDED ya da INGEST_RATING_CHANGED
+static int dirtyCount = 0;
+
+// Dosya izleyen iş parçacığı
+static pthread_t followThread;
+static int following = 0;
+static volatile int stopping = 0;
+static char *followName = NULL;
+static long followOffset = 0;
+
+void ingestStart(void) {
+    pthread_rwlockattr_t attributes;
+    pthread_rwlockattr_init(&attributes);
+    pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    pthread_rwlock_init(&dataLock, &attributes);
+    pthread_rwlockattr_destroy(&attributes);
+
+    makeDataGrowable();
+    share_rating_data(ratingMatrix);  //tür sayıları ve tür listeleri yüklemede kuruldu, yerinde güncellenir
+
+    int vertices = graphVertices(ratingMatrix);
+    dirtyIndex = (int *)calloc(vertices, sizeof(int));
+    dirtyList = (int *)malloc(vertices * sizeof(int));
+    dirtyChange = (unsigned char *)malloc(vertices);
+    dirtyCount = 0;
+    memset(&totals, 0, sizeof(totals));
+    active = 1;
+}
+
+void ingestSetListener(IngestListener callback, void *ctx) {
+    listener = callback;
+    listenerContext = ctx;
+}
+
+int ingestActive(void) {
+    return active;
+}
+
+void ingestReadLock(void) {
+    if (active) {
+        pthread_rwlock_rdlock(&dataLock);
+    }
+}
+
+void ingestReadUnlock(void) {
+    if (active) {
+        pthread_rwlock_unlock(&dataLock);
+    }
+}
+
+static void markDirty(int vertex, unsigned char change) {
+    if (dirtyIndex[vertex] == 0) {
+        dirtyList[dirtyCount] = vertex;
+        dirtyChange[dirtyCount] = change;
+        dirtyIndex[vertex] = ++dirtyCount;
+    } else if (change == INGEST_RATING_CHANGED) {
+        dirtyChange[dirtyIndex[vertex] - 1] = change;
+    }
+}
+
+// Tek bir puanı tüm yapılara işler (yazma kilidi tutulurken çağrılır)
+static void applyRating(const Rating *r, IngestStats *stats) {
+    if (r->user < 1 || r->user > numUsers || r->movie < 1 || r->movie > numMovies ||
+        r->rating < 1 || r->rating > RATING_LEVELS) {
+        stats->skipped++;
+        return;
+    }
+    long at = findInRow(ratingMatrix, r->user - 1, r->movie - 1);
+    unsigned int oldTime = at >= 0 ? ratingMatrix->rowTimes[at] : 0;
+    // Depoya yazmak satırı, sütunu (yani grafiğin iki yönlü kenarını), filmin derecesini ve ortalamasını günceller
+    int old = setMatrixRating(ratingMatrix, r->user - 1, r->movie - 1, r->rating, r->timestamp);
+    if (old == r->rating) {
+        // Aynı puan yeniden verildi: taze yüklemede de çiftin son satırı kaldığı için sadece zamanı yenilenir,
+        // trend skoru değiştiğinden film yine de değişmiş sayılır
+        if (oldTime != r->timestamp) {
+            ratingMatrix->rowTimes[at] = r->timestamp;
+            if (trendIndex != NULL) {
+                trendMoveRating(trendIndex, r->movie - 1, oldTime, r->timestamp);
+                markDirty(numUsers + r->movie - 1, INGEST_RATING_CHANGED);
+            }
+        }
+        stats->unchanged++;
+        return;
+    }
+
+    unsigned char change = old == 0 ? INGEST_RATING_ADDED : INGEST_RATING_CHANGED;
+    if (old == 0) {
+        add_user_genres(r->user - 1, r->movie - 1, 1);
+        if (userIndex != NULL) {
+            addMinHashRating(userIndex, r->user - 1, r->movie - 1);
+        }
+        if (trendIndex != NULL) {
+            trendAddRating(trendIndex, r->movie - 1, r->timestamp);
+        }
+        stats->added++;
+    } else {
+        if (trendIndex != NULL) {
+            trendMoveRating(trendIndex, r->movie - 1, oldTime, r->timestamp);  //depo da zamanı yeniledi
+        }
+        stats->changed++;
+    }
+    markDirty(r->user - 1, change);
+    markDirty(numUsers + r->movie - 1, change);
+}
+
+void ingestRatings(const Rating *items, long count, IngestStats *stats) {
+    IngestStats local = {0, 0, 0, 0};
+    for (long first = 0; first < count; first += INGEST_BATCH) {
+        long last = first + INGEST_BATCH < count ? first + INGEST_BATCH : count;
+        pthread_rwlock_wrlock(&dataLock);
+        for (long i = first; i < last; i++) {
+            applyRating(&items[i], &local);
+        }
+        updateWalkTable(walk_table, dirtyList, dirtyCount);
+        if (listener != NULL && dirtyCount > 0) {
+            listener(dirtyList, dirtyChange, dirtyCount, listenerContext);
+        }
+        unsigned int genreMask = 0;  //ortalaması değişen filmlerin türlerinin listeleri yeniden sıralanır
+        for (int i = 0; i < dirtyCount; i++) {
+            if (dirtyList[i] >= numUsers) {
+                genreMask |= movie_genres[dirtyList[i] - numUsers];
+            }
+            dirtyIndex[dirtyList[i]] = 0;
+        }
+        if (bayes_prior > 0 && dirtyCount > 0) {
+            genreMask = (1u << MAX_GENRES) - 1;  //Bayes ortalaması genel ortalamaya bağlı, her puan tüm filmleri kaydırır
+        }
+        refresh_genre_postings(genreMask);
+        dirtyCount = 0;
+        pthread_rwlock_unlock(&dataLock);
+    }
+
+    pthread_rwlock_wrlock(&dataLock);
+    totals.added += local.added;
+    totals.changed += local.changed;
+    totals.unchanged += local.unchanged;
+    totals.skipped += local.skipped;
+    pthread_rwlock_unlock(&dataLock);
+    if (stats != NULL) {
+        stats->added += local.added;
+        stats->changed += local.changed;
+        stats->unchanged += local.unchanged;
+        stats->skipped += local.skipped;
+    }
+}
+
+void ingestTotals(IngestStats *stats) {
+    pthread_rwlock_rdlock(&dataLock);
+    *stats = totals;
+    pthread_rwlock_unlock(&dataLock);
+}
+
+static void sleepMillis(long millis) {
+    struct timespec ts = {millis / 1000, (millis % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+// Dosyanın sonuna eklenen baytlar okunur; son satır sonuna kadar olan kısım ayrıştırılıp uygulanır,
+// yarım kalan satır bir sonraki okumayı bekler
+static void *followFile(void *arg) {
+    (void)arg;
+    size_t capacity = INGEST_READ_BYTES;
+    char *buffer = (char *)malloc(capacity);
+    size_t pending = 0;
+    long offset = followOffset;
+    int fd = -1;
+    ino_t inode = 0;
+
+    while (!stopping) {
+        struct stat info;
+        if (stat(followName, &info) != 0) {
+            sleepMillis(INGEST_POLL_MS);
+            continue;
+        }
+        if (fd < 0 || info.st_ino != inode) {
+            if (fd >= 0) {
+                close(fd);  //dosyanın yerine yenisi konmuş
+                offset = 0;
+                pending = 0;
+            }
+            fd = open(followName, O_RDONLY);
+            if (fd < 0) {
+                sleepMillis(INGEST_POLL_MS);
+                continue;
+            }
+            inode = info.st_ino;
+        }
+        if (info.st_size < offset) {
+            offset = 0;  //dosya kısalmış
+            pending = 0;
+        }
+        if (info.st_size == offset) {
+            sleepMillis(INGEST_POLL_MS);
+            continue;
+        }
+
+        if (pending == capacity) {
+            capacity *= 2;  //satır sonu gelmeden tampon doldu
+            buffer = (char *)realloc(buffer, capacity);
+        }
+        ssize_t got = pread(fd, buffer + pending, capacity - pending, offset);
+        if (got <= 0) {
+            sleepMillis(INGEST_POLL_MS);
+            continue;
+        }
+        offset += got;
+        pending += got;
+
+        char *lastNewline = memrchr(buffer, '\n', pending);
+        if (lastNewline == NULL) {
+            continue;
+        }
+        size_t complete = lastNewline - buffer + 1;
+        RatingSet set;
+        parseRatingText(buffer, complete, &set);
+        IngestStats stats = {0, 0, 0, 0};
+        ingestRatings(set.items, set.count, &stats);
+        freeRatingSet(&set);
+        if (stats.skipped > 0) {
+            fprintf(stderr, "%s: %ld puan atlandi (yuklemede olmayan kullanici/film ya da gecersiz puan)\n",
+                    followName, stats.skipped);
+        }
+        memmove(buffer, buffer + complete, pending - complete);
+        pending -= complete;
+    }
+
+    if (fd >= 0) {
+        close(fd);
+    }
+    free(buffer);
+    return NULL;
+}
+
+int ingestFollow(const char *fileName, long offset) {
+    if (!active || following) {
+        return -1;
+    }
+    followName = strdup(fileName);
+    followOffset = offset;
+    stopping = 0;
+    if (pthread_create(&followThread, NULL, followFile, NULL) != 0) {
+        free(followName);
+        followName = NULL;
+        return -1;
+    }
+    following = 1;
+    return 0;
+}
+
+void ingestStop(void) {
+    if (following) {
+        stopping = 1;
+        pthread_join(followThread, NULL);
+        following = 0;
+        free(followName);
+        followName = NULL;
+    }
+    if (active) {
+        free(dirtyIndex);
+        free(dirtyList);
+        free(dirtyChange);
+        dirtyIndex = NULL;
+        dirtyList = NULL;
+        dirtyChange = NULL;
+        pthread_rwlock_destroy(&dataLock);
+        active = 0;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef INGEST_H
+#define INGEST_H
+
+#include "loader.h"
+#include "graph.h"
+
+// Canlı güncelleme: yeni puanlar (ya da verilmiş bir puanın değişmesi) hiçbir şey baştan kurulmadan yerinde işlenir.
+// ingestStart oneri1'in puan deposunu büyüyebilen (satır ve sütun sonlarında boş yer bırakılmış) kopyasına
+// çevirir ve oneri2'ye de aynı depoyu kullandırır. Sonra her puan için
+//   puan deposu (satır, sütun, film toplamları ve dereceleri, bit düzlemleri; grafiğin kenarları da bunlardır),
+//   kullanıcının tür sayıları (user_genre_count), -L verildiyse MinHash imzaları, -T verildiyse trend dizini
+// güncellenir. Yeni puan ortalamada sabit zamanda eklenir (sıralı satırda ve sütunda kuyruğu kaydırmak dışında).
+// Rastgele yürüyüş tabloları ve türlerin sıralı listeleri her grubun sonunda sadece değişen düğümler için
+// yeniden kurulur (bkz. walk.h). -p (Bayes ortalaması) verildiyse her puan genel ortalamayı, dolayısıyla tüm
+// filmlerin tür puanını değiştirir; o zaman grupta puan değiştiyse tüm türlerin listeleri yeniden sıralanır.
+//
+// Tutarlılık: sorgular ingestReadLock / ingestReadUnlock arasında çalışır, güncellemeler INGEST_BATCH'lik
+// gruplar halinde yazma kilidiyle uygulanır. Bir sorgu bir grubun ya tamamını ya da hiçbirini görür.
+// Kilit yazıcı önceliklidir; sürekli sorgu gelse de güncellemeler bekletilmez, sorgular da en fazla bir grup bekler.
+//
+// Yüklemedeki kullanıcı/film aralığı dışındaki id'ler (yeni kullanıcı ya da film) grafikte film düğümlerinin
+// numaralarını kaydıracağı için uygulanmaz, atlanmış sayılır; onlar için derle ile yeniden kurmak gerekir.
+// Silme yoktur: izlenen dosyadan bir satırın çıkarılması puanı geri almaz.
+
+#define INGEST_BATCH 8192
+#define INGEST_POLL_MS 200           //izlenen dosyada yeni satır yoksa bekleme süresi
+#define INGEST_READ_BYTES (1L << 20) //izlenen dosyadan bir seferde okunan en fazla bayt
+
+// Bir gruptaki düğüm değişikliği (bkz. IngestListener)
+#define INGEST_RATING_ADDED 1    //düğüme yeni puan (kenar) eklendi
+#define INGEST_RATING_CHANGED 2  //var olan bir puanı değişti
+
+typedef struct IngestStats {
+    long added;     //yeni kullanıcı-film çifti
+    long changed;   //puanı değişen çift
+    long unchanged; //aynı puan tekrar geldi
+    long skipped;   //aralık dışı id ya da geçersiz puan
+} IngestStats;
+
+// oneri1 ve oneri2 verisi yüklendikten sonra, sorgular başlamadan çağrılır.
+// ratingMatrix büyüyebilen kopyasıyla değiştirilir; eski göstericiler saklanmamış olmalıdır.
+void ingestStart(void);
+int ingestActive(void);
+
+// Canlı mod açık değilse ikisi de bir şey yapmaz
+void ingestReadLock(void);
+void ingestReadUnlock(void);
+
+// Puanları dizideki sırayla uygular; stats verilirse bu çağrının sayıları eklenir
+void ingestRatings(const Rating *items, long count, IngestStats *stats);
+// Başlangıçtan beri uygulanan toplamlar
+void ingestTotals(IngestStats *stats);
+
+// Her grup uygulandıktan sonra, yazma kilidi bırakılmadan çağrılır (ör. önbellekten etkilenen sonuçları atmak için).
+// vertices kenarı değişen grafik düğümleri (kullanıcı user - 1, film numUsers + film - 1), changes her birinin
+// INGEST_RATING_ADDED (yeni puan) ya da INGEST_RATING_CHANGED (var olan puan değişti) olduğu.
+// ingestStart'tan sonra, ingestFollow'dan önce verilmelidir.
+typedef void (*IngestListener)(const int *vertices, const unsigned char *changes, int count, void *ctx);
+void ingestSetListener(IngestListener listener, void *ctx);
+
+// fileName'in offset'ten sonrasını arka planda izler: dosyaya eklenen tam satırlar puan olarak uygulanır.
+// Dosya kısalırsa ya da yerine yenisi konursa baştan okunur (aynı puanı yeniden uygulamak bir şey değiştirmez).
+int ingestFollow(const char *fileName, long offset);
+// İzlemeyi durdurur (iş parçacığı bitene kadar bekler)
+void ingestStop(void);
+
+#endif
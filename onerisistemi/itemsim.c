@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "itemsim.h"
+#include "batch.h"
+#include "metrics.h"
+
+// Tabloyu kuran iş parçacıklarının ortak durumu
+typedef struct BuildState {
+    const RatingMatrix *matrix;
+    const double *userMean;  //users
+    const double *norm;      //movies, sapmaların normu
+    int neighbors;
+    int nextMovie;           //sıradaki film, atomik olarak artırılır
+    int *ids;
+    float *scores;
+} BuildState;
+
+// Film i'nin satırı: sütundaki her kullanıcının satırı gezilerek i ile ortak puanlanan filmlerin
+// sapma çarpımları ve ortak kullanıcı sayıları toplanır, en benzer neighbors film seçilir
+static void buildRow(BuildState *state, int movie, double *dot, int *together, int *touched, ScoredItem *best) {
+    const RatingMatrix *matrix = state->matrix;
+    int *ids = state->ids + (long)movie * state->neighbors;
+    float *scores = state->scores + (long)movie * state->neighbors;
+    for (int k = 0; k < state->neighbors; k++) {
+        ids[k] = -1;
+        scores[k] = 0;
+    }
+    if (state->norm[movie] == 0) {
+        return;
+    }
+
+    int touchedCount = 0;
+    int raters;
+    const int *users = movieColumn(matrix, movie, &raters);
+    const unsigned char *raterRatings = matrix->colRatings + matrix->colOffsets[movie];
+    for (int a = 0; a < raters; a++) {
+        int user = users[a];
+        double mean = state->userMean[user];
+        double deviation = raterRatings[a] - mean;
+        long end = matrix->rowEnds[user];
+        for (long p = matrix->rowOffsets[user]; p < end; p++) {
+            int other = matrix->rowMovies[p];
+            if (together[other]++ == 0) {
+                touched[touchedCount++] = other;
+            }
+            dot[other] += deviation * (matrix->rowRatings[p] - mean);
+        }
+    }
+
+    TopK topk;
+    topkInit(&topk, best, state->neighbors);
+    for (int t = 0; t < touchedCount; t++) {
+        int other = touched[t];
+        if (other != movie && dot[other] > 0 && state->norm[other] > 0) {
+            double shrink = together[other] / (together[other] + ITEM_SHRINK);
+            topkPush(&topk, other, dot[other] / (state->norm[movie] * state->norm[other]) * shrink);
+        }
+        dot[other] = 0;
+        together[other] = 0;
+    }
+    int count = topkFinish(&topk);
+    for (int k = 0; k < count; k++) {
+        ids[k] = best[k].id;
+        scores[k] = (float)best[k].score;
+    }
+}
+
+static void *buildWorker(void *arg) {
+    BuildState *state = (BuildState *)arg;
+    int movies = state->matrix->movies;
+    double *dot = (double *)calloc(movies, sizeof(double));
+    int *together = (int *)calloc(movies, sizeof(int));
+    int *touched = (int *)malloc(movies * sizeof(int));
+    ScoredItem *best = (ScoredItem *)malloc(state->neighbors * sizeof(ScoredItem));
+
+    for (;;) {
+        int movie = __atomic_fetch_add(&state->nextMovie, 1, __ATOMIC_RELAXED);
+        if (movie >= movies) {
+            break;
+        }
+        buildRow(state, movie, dot, together, touched, best);
+    }
+
+    free(dot);
+    free(together);
+    free(touched);
+    free(best);
+    return NULL;
+}
+
+ItemNeighbors *buildItemNeighbors(const RatingMatrix *matrix, int neighbors, int threads) {
+    METRICS_BEGIN(PHASE_ITEM_BUILD);
+    int users = matrix->users;
+    int movies = matrix->movies;
+    double *userMean = (double *)calloc(users, sizeof(double));
+    double *norm = (double *)calloc(movies, sizeof(double));
+    for (int u = 0; u < users; u++) {
+        long start = matrix->rowOffsets[u];
+        long end = matrix->rowEnds[u];
+        long sum = 0;
+        for (long p = start; p < end; p++) {
+            sum += matrix->rowRatings[p];
+        }
+        userMean[u] = end > start ? (double)sum / (end - start) : 0.0;
+    }
+    for (int m = 0; m < movies; m++) {
+        int raters;
+        const int *column = movieColumn(matrix, m, &raters);
+        const unsigned char *ratings = matrix->colRatings + matrix->colOffsets[m];
+        double squares = 0;
+        for (int a = 0; a < raters; a++) {
+            double deviation = ratings[a] - userMean[column[a]];
+            squares += deviation * deviation;
+        }
+        norm[m] = sqrt(squares);
+    }
+
+    ItemNeighbors *table = (ItemNeighbors *)malloc(sizeof(ItemNeighbors));
+    int *ids = (int *)malloc((long)movies * neighbors * sizeof(int));
+    float *scores = (float *)malloc((long)movies * neighbors * sizeof(float));
+    BuildState state = {matrix, userMean, norm, neighbors, 0, ids, scores};
+
+    if (threads <= 0) {
+        threads = defaultThreadCount();
+    }
+    if (threads > movies) {
+        threads = movies;
+    }
+    pthread_t *workers = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, buildWorker, &state);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    free(userMean);
+    free(norm);
+
+    table->movies = movies;
+    table->neighbors = neighbors;
+    table->ids = ids;
+    table->scores = scores;
+    table->owned = 1;
+    METRICS_END(PHASE_ITEM_BUILD);
+    return table;
+}
+
+void freeItemNeighbors(ItemNeighbors *table) {
+    if (table != NULL && table->owned) {
+        free((int *)table->ids);
+        free((float *)table->scores);
+        free(table);
+    }
+}
+
+ItemScratch *createItemScratch(int movies) {
+    ItemScratch *scratch = (ItemScratch *)malloc(sizeof(ItemScratch));
+    scratch->scores = (double *)calloc(movies, sizeof(double));
+    scratch->touched = (int *)malloc(movies * sizeof(int));
+    scratch->items = (ScoredItem *)malloc(movies * sizeof(ScoredItem));
+    return scratch;
+}
+
+void freeItemScratch(ItemScratch *scratch) {
+    free(scratch->scores);
+    free(scratch->touched);
+    free(scratch->items);
+    free(scratch);
+}
+
+int recommendSimilarItems(const ItemNeighbors *table, const RatingMatrix *matrix, int user, int rec,
+                          ItemScratch *scratch, int *out) {
+    METRICS_BEGIN(PHASE_ITEM);
+    int length;
+    const int *rated = userRow(matrix, user - 1, &length);
+    const unsigned char *ratings = matrix->rowRatings + matrix->rowOffsets[user - 1];
+    double *scores = scratch->scores;
+    int touchedCount = 0;
+
+    for (int i = 0; i < length; i++) {
+        if (rated[i] >= table->movies) {
+            continue;
+        }
+        const int *ids = table->ids + (long)rated[i] * table->neighbors;
+        const float *similarity = table->scores + (long)rated[i] * table->neighbors;
+        for (int k = 0; k < table->neighbors && ids[k] >= 0; k++) {
+            if (scores[ids[k]] == 0) {
+                scratch->touched[touchedCount++] = ids[k];
+            }
+            scores[ids[k]] += similarity[k] * ratings[i];
+        }
+    }
+    METRICS_ADD(METRIC_CANDIDATES_SCORED, touchedCount);
+
+    // Puanlanan filmler aday olur; izlenmiş olanlar atlanır, toplayıcılar bir sonraki sorgu için sıfırlanır
+    int candidates = 0;
+    for (int t = 0; t < touchedCount; t++) {
+        int movie = scratch->touched[t];
+        if (!hasRated(matrix, user - 1, movie)) {
+            scratch->items[candidates].score = scores[movie];
+            scratch->items[candidates].id = movie + 1;
+            candidates++;
+        }
+        scores[movie] = 0;
+    }
+    int count = selectTopK(scratch->items, candidates, rec);
+    for (int k = 0; k < count; k++) {
+        out[k] = scratch->items[k].id;
+    }
+    METRICS_END(PHASE_ITEM);
+    return count;
+}
@@ -0,0 +1,51 @@
+#ifndef ITEMSIM_H
+#define ITEMSIM_H
+
+#include "bitmatrix.h"
+#include "topk.h"
+
+// Film-film benzerliği (item-item): her film için en benzer ITEM_NEIGHBORS film ve benzerlikleri.
+// Benzerlik düzeltilmiş kosinüstür (adjusted cosine): puanlardan kullanıcının ortalaması çıkarılır,
+//   s(i, j) = sum_u (r_ui - m_u)(r_uj - m_u) / (|i| |j|) * n / (n + ITEM_SHRINK)
+// |i| filmin tüm sapmalarının normu, n iki filme birlikte puan veren kullanıcı sayısıdır;
+// az ortak kullanıcıya dayanan benzerlikler son çarpanla küçültülür. Sadece pozitif benzerlikler tutulur.
+//
+// Tablo puan matrisinin kendi devriğiyle çarpımından (X^T X) satır satır çıkar: film i'nin sütunundaki her
+// kullanıcının satırı gezilir, iş O(sum_u puan(u)^2). Filmler iş parçacıklarına dağıtılır; her iş parçacığının
+// film sayısı kadar yoğun toplayıcısı vardır, sonuç iş parçacığı sayısından bağımsızdır.
+// derle tabloyu snapshot'a yazar; snapshot yoksa veri yüklenirken kurulur. Canlı modda tablo güncellenmez,
+// yeni puanlar sadece kullanıcının profili üzerinden etkiler.
+
+#define ITEM_NEIGHBORS 50
+#define ITEM_SHRINK 10.0
+
+// ids[m * neighbors + k]: film m'nin k. komşusu (0 tabanlı, benzerliğe göre azalan), komşu yoksa -1
+typedef struct ItemNeighbors {
+    int movies;
+    int neighbors;
+    const int *ids;
+    const float *scores;
+    int owned;          //diziler snapshot'ın içindeyse 0
+} ItemNeighbors;
+
+// Sorgu başına çalışma alanı (iş parçacığı başına bir tane)
+typedef struct ItemScratch {
+    double *scores;     //movies, kullanılmayanlar 0
+    int *touched;       //puan alan filmler, sorgu sonunda sıfırlanır
+    ScoredItem *items;  //movies
+} ItemScratch;
+
+// threads 0 ise çekirdek sayısı kadar
+ItemNeighbors *buildItemNeighbors(const RatingMatrix *matrix, int neighbors, int threads);
+void freeItemNeighbors(ItemNeighbors *table);
+
+ItemScratch *createItemScratch(int movies);
+void freeItemScratch(ItemScratch *scratch);
+
+// Kullanıcının izlemediği filmler, puan verdiği filmlerin komşularından puanlanır:
+//   skor(j) = sum_i s(i, j) * r_ui   (i kullanıcının puanladığı filmler)
+// İş O(puan(u) * neighbors). Kullanıcı ve dönen filmler 1 tabanlıdır, öneri sayısı döner.
+int recommendSimilarItems(const ItemNeighbors *table, const RatingMatrix *matrix, int user, int rec,
+                          ItemScratch *scratch, int *out);
+
+#endif
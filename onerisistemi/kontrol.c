@@ -0,0 +1,361 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "loader.h"
+#include "rng.h"
+
+// Sunucunun canlı modunu ve önbelleğini baştan yüklemeyle karşılaştıran kontrol (make check).
+// Kullanım: ./kontrol [-f puanlar] [-i filmler] [-n satir] [-q sorgu] [-s tohum]
+// 1. canlı: puan dosyasının bir kopyasıyla "sunucu -F" açılır, kopyanın sonuna -n rastgele satır eklenir. Hepsi
+//    işlenince ("ingest") aynı dosyayı baştan yükleyen ikinci bir sunucu açılır, her KONTROL_USER_STEP. kullanıcı
+//    için tüm yöntemlerin cevapları karşılaştırılır.
+//    Aynı karşılaştırma -p KONTROL_PRIOR (Bayes ortalaması) ile bir kez daha yapılır; bu sefer satırlar sadece tek
+//    türü olan en az filmli türün filmlerine eklenir. Ortalama her puanla değiştiği için diğer türlerin sırası da
+//    kaymalıdır; sadece değişen filmlerin türlerini yeniden sıralayan bir hata genre cevaplarında görünür.
+// 2. önbellek: biri önbellekli, biri -C 0 iki canlı sunucuya aynı rastgele "add" ve sorgu dizisi gönderilir,
+//    -q sorgunun cevapları karşılaştırılır. Sorgular az sayıda kullanıcıda toplanır ki önbellek isabet etsin.
+// item karşılaştırılmaz: film-film komşuları yüklemede bir kez kurulur, canlı modda güncellenmez (bkz. README);
+// baştan yüklenen sunucununki yeni puanlardan kurulur. mf için model gerekir, o da dışarıda kalır.
+// Sunucu bu dizindeki ./sunucu'dur. Fark çıkarsa ilk birkaçı yazılır ve program 1 ile biter.
+
+#define KONTROL_USER_STEP 7
+#define KONTROL_HOT_USERS 40
+#define KONTROL_SHOW 5             //en fazla bu kadar fark yazılır
+#define KONTROL_WAIT_SECONDS 60    //sunucunun açılması ve eklenen satırları işlemesi için beklenen süre
+#define KONTROL_REPLY_MAX 8192
+#define KONTROL_PRIOR "5"
+#define KONTROL_GENRE_MIN 10       //-p karşılaştırmasında seçilen türün en az bu kadar tek türlü filmi olmalı
+
+static const char *liveAlgorithms[] = {
+    "random", "high_degree", "similar_user", "nearest", "genre", "walk", "trending"
+};
+static const char *cacheAlgorithms[] = {
+    "random", "high_degree", "similar_user", "nearest", "item", "genre", "walk", "trending"
+};
+#define LIVE_ALGORITHMS (int)(sizeof(liveAlgorithms) / sizeof(liveAlgorithms[0]))
+#define CACHE_ALGORITHMS (int)(sizeof(cacheAlgorithms) / sizeof(cacheAlgorithms[0]))
+
+typedef struct Server {
+    pid_t pid;
+    int fd;
+    FILE *in;
+    char socketPath[96];
+} Server;
+
+static void sleepMillis(long millis) {
+    struct timespec ts = {millis / 1000, (millis % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+// ./sunucu'yu açar ve soketine bağlanır; prior NULL değilse -p, cacheOff ise -C 0 verilir. Açılamazsa -1 döner
+static int startServer(Server *server, const char *ratingsFile, const char *itemsFile, const char *name,
+                       const char *seed, const char *prior, int cacheOff) {
+    snprintf(server->socketPath, sizeof(server->socketPath), "/tmp/kontrol_%d_%s.sock", (int)getpid(), name);
+    unlink(server->socketPath);
+    const char *args[24] = {
+        "./sunucu", "-f", ratingsFile, "-i", itemsFile, "-F", "-T", "7", "-w", "3000", "-s", seed, "-u", server->socketPath
+    };
+    int argCount = 14;
+    if (prior != NULL) {
+        args[argCount++] = "-p";
+        args[argCount++] = prior;
+    }
+    if (cacheOff) {
+        args[argCount++] = "-C";
+        args[argCount++] = "0";
+    }
+    args[argCount] = NULL;
+    server->pid = fork();
+    if (server->pid == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        execv(args[0], (char *const *)args);
+        _exit(127);
+    }
+    if (server->pid < 0) {
+        printf("Sunucu baslatilamadi.\n");
+        return -1;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, server->socketPath);
+    for (int attempt = 0; attempt < KONTROL_WAIT_SECONDS * 20; attempt++) {
+        int status;
+        if (waitpid(server->pid, &status, WNOHANG) == server->pid) {
+            printf("Sunucu acilirken kapandi (./sunucu derlendi mi?)\n");
+            return -1;
+        }
+        server->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(server->fd, (struct sockaddr *)&address, sizeof(address)) == 0) {
+            server->in = fdopen(dup(server->fd), "r");
+            return 0;
+        }
+        close(server->fd);
+        sleepMillis(50);
+    }
+    printf("Sunucuya baglanilamadi: %s\n", server->socketPath);
+    kill(server->pid, SIGTERM);
+    waitpid(server->pid, NULL, 0);
+    return -1;
+}
+
+static void stopServer(Server *server) {
+    fclose(server->in);
+    close(server->fd);
+    kill(server->pid, SIGTERM);
+    waitpid(server->pid, NULL, 0);
+    unlink(server->socketPath);
+}
+
+// İsteği gönderip tek satırlık cevabı reply'a yazar; sunucu kapandıysa program biter
+static void ask(Server *server, const char *request, char *reply) {
+    char line[256];
+    int length = snprintf(line, sizeof(line), "%s\n", request);
+    if (send(server->fd, line, length, MSG_NOSIGNAL) != length || fgets(reply, KONTROL_REPLY_MAX, server->in) == NULL) {
+        printf("Sunucu cevap vermedi: %s\n", request);
+        exit(1);
+    }
+}
+
+static int compareReplies(Server *a, Server *b, const char *request, long *mismatches) {
+    char replyA[KONTROL_REPLY_MAX];
+    char replyB[KONTROL_REPLY_MAX];
+    ask(a, request, replyA);
+    ask(b, request, replyB);
+    if (strcmp(replyA, replyB) == 0) {
+        return 0;
+    }
+    if ((*mismatches)++ < KONTROL_SHOW) {
+        printf("  fark: %s\n    %s    %s", request, replyA, replyB);
+    }
+    return 1;
+}
+
+static int copyFile(const char *from, const char *to) {
+    FILE *in = fopen(from, "rb");
+    FILE *out = fopen(to, "wb");
+    if (in == NULL || out == NULL) {
+        printf("Dosya kopyalanamadi: %s -> %s\n", from, to);
+        if (in) fclose(in);
+        if (out) fclose(out);
+        return -1;
+    }
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        fwrite(buffer, 1, n, out);
+    }
+    fclose(in);
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+// Canlı sunucunun o ana kadar işlediği satır sayısı
+static long ingestedLines(Server *server) {
+    char reply[KONTROL_REPLY_MAX];
+    long added, changed, unchanged, skipped;
+    ask(server, "ingest", reply);
+    if (sscanf(reply, "eklenen %ld degisen %ld ayni %ld atlanan %ld", &added, &changed, &unchanged, &skipped) != 4) {
+        return -1;
+    }
+    return added + changed + unchanged + skipped;
+}
+
+// Eklenen satırların filmleri movies içinden (movieCount tane, 1 tabanlı id) seçilir
+static long checkLive(const char *copyPath, const char *itemsFile, const RatingSet *set, const int *movies,
+                      int movieCount, int lines, unsigned long long seed, const char *seedText, const char *prior) {
+    Server live, fresh;
+    if (startServer(&live, copyPath, itemsFile, "canli", seedText, prior, 0) != 0) {
+        return -1;
+    }
+    unsigned int lastTime = 0;
+    for (long i = 0; i < set->count; i++) {
+        if (set->items[i].timestamp > lastTime) {
+            lastTime = set->items[i].timestamp;
+        }
+    }
+    Rng rng;
+    rngSeed(&rng, seed);
+    FILE *file = fopen(copyPath, "a");
+    for (int i = 0; i < lines; i++) {
+        fprintf(file, "%d\t%d\t%d\t%u\n", 1 + rngRange(&rng, set->maxUser), movies[rngRange(&rng, movieCount)],
+                1 + rngRange(&rng, 5), lastTime + 1 + i);
+    }
+    fclose(file);
+
+    long done = 0;
+    for (int attempt = 0; attempt < KONTROL_WAIT_SECONDS * 20 && (done = ingestedLines(&live)) < lines; attempt++) {
+        sleepMillis(50);
+    }
+    if (done != lines) {
+        printf("Canli sunucu eklenen satirlari islemedi (%ld / %d)\n", done, lines);
+        stopServer(&live);
+        return -1;
+    }
+    if (startServer(&fresh, copyPath, itemsFile, "yeni", seedText, prior, 0) != 0) {
+        stopServer(&live);
+        return -1;
+    }
+
+    long mismatches = 0;
+    long requests = 0;
+    char request[64];
+    for (int user = 1; user <= set->maxUser; user += KONTROL_USER_STEP) {
+        for (int a = 0; a < LIVE_ALGORITHMS; a++) {
+            snprintf(request, sizeof(request), "%s %d 10", liveAlgorithms[a], user);
+            compareReplies(&live, &fresh, request, &mismatches);
+            requests++;
+        }
+        // Geçmişteki bir ana göre ve eklenen satırları da içine alan bir aralıkta trending
+        snprintf(request, sizeof(request), "trending %d 10 %u", user, lastTime - 30 * 86400);
+        compareReplies(&live, &fresh, request, &mismatches);
+        snprintf(request, sizeof(request), "trending %d 10 %u %u", user, lastTime - 30 * 86400, lastTime + lines);
+        compareReplies(&live, &fresh, request, &mismatches);
+        requests += 2;
+    }
+    printf("canli%s%s: %d satir, %d filme eklendi, %ld istek, %ld fark\n", prior ? " -p " : "", prior ? prior : "",
+           lines, movieCount, requests, mismatches);
+    stopServer(&live);
+    stopServer(&fresh);
+    return mismatches;
+}
+
+static long checkCache(const char *copyPath, const char *itemsFile, const RatingSet *set, int queries,
+                       unsigned long long seed, const char *seedText) {
+    Server cached, plain;
+    if (startServer(&cached, copyPath, itemsFile, "onbellek", seedText, NULL, 0) != 0) {
+        return -1;
+    }
+    if (startServer(&plain, copyPath, itemsFile, "onbelleksiz", seedText, NULL, 1) != 0) {
+        stopServer(&cached);
+        return -1;
+    }
+    Rng rng;
+    rngSeed(&rng, seed + 1);
+    int hot[KONTROL_HOT_USERS];
+    for (int i = 0; i < KONTROL_HOT_USERS; i++) {
+        hot[i] = 1 + rngRange(&rng, set->maxUser);
+    }
+
+    long mismatches = 0;
+    long adds = 0;
+    char request[64];
+    for (int q = 0; q < queries;) {
+        if (rngRange(&rng, 100) < 8) {
+            // Puanların bir kısmı sorgulanan kullanıcılara ve popüler filmlere gelsin ki önbellekteki cevaplar etkilensin
+            int user = rngRange(&rng, 10) < 3 ? hot[rngRange(&rng, KONTROL_HOT_USERS)] : 1 + rngRange(&rng, set->maxUser);
+            int movie = 1 + rngRange(&rng, rngRange(&rng, 2) ? set->maxMovie : (set->maxMovie < 200 ? set->maxMovie : 200));
+            snprintf(request, sizeof(request), "add %d %d %d", user, movie, 1 + rngRange(&rng, 5));
+            compareReplies(&cached, &plain, request, &mismatches);
+            adds++;
+        } else {
+            snprintf(request, sizeof(request), "%s %d %d", cacheAlgorithms[rngRange(&rng, CACHE_ALGORITHMS)],
+                     hot[rngRange(&rng, KONTROL_HOT_USERS)], rngRange(&rng, 2) ? 5 : 10);
+            compareReplies(&cached, &plain, request, &mismatches);
+            q++;
+        }
+    }
+    char stats[KONTROL_REPLY_MAX];
+    ask(&cached, "cache", stats);
+    printf("onbellek: %d sorgu, %ld ekleme, %ld fark (%.*s)\n", queries, adds, mismatches,
+           (int)strcspn(stats, "\n"), stats);
+    stopServer(&cached);
+    stopServer(&plain);
+    return mismatches;
+}
+
+int main(int argc, char *argv[]) {
+    const char *ratingsFile = "u.data";
+    const char *itemsFile = "u.item";
+    int lines = 3000;
+    int queries = 6000;
+    const char *seedText = "7";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            ratingsFile = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            itemsFile = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            lines = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc) {
+            queries = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seedText = argv[++i];
+        } else {
+            printf("Kullanim: %s [-f puanlar] [-i filmler] [-n satir] [-q sorgu] [-s tohum]\n", argv[0]);
+            return 1;
+        }
+    }
+    unsigned long long seed = strtoull(seedText, NULL, 10);
+
+    RatingSet set;
+    if (loadRatings(ratingsFile, 0, &set) != 0 || set.count == 0) {
+        printf("Puan dosyasi okunamadi: %s\n", ratingsFile);
+        return 1;
+    }
+    MovieGenres genres;
+    if (loadMovieGenres(itemsFile, &genres) != 0) {
+        printf("Film turleri dosyasi acilamadi: %s\n", itemsFile);
+        return 1;
+    }
+    // İlk karşılaştırmada tüm filmler; -p ile olanında tek türü olan filmleri en az (ama KONTROL_GENRE_MIN'den
+    // az olmayan) türün filmleri
+    int *allMovies = (int *)malloc(set.maxMovie * sizeof(int));
+    int *genreMovies = (int *)malloc(set.maxMovie * sizeof(int));
+    int genreCounts[32] = {0};
+    for (int movie = 1; movie <= set.maxMovie; movie++) {
+        allMovies[movie - 1] = movie;
+        unsigned int mask = movie <= genres.maxMovie ? genres.genres[movie] : 0;
+        if (mask != 0 && (mask & (mask - 1)) == 0) {
+            genreCounts[__builtin_ctz(mask)]++;
+        }
+    }
+    int rareGenre = -1;
+    for (int g = 0; g < 32; g++) {
+        if (genreCounts[g] >= KONTROL_GENRE_MIN && (rareGenre == -1 || genreCounts[g] < genreCounts[rareGenre])) {
+            rareGenre = g;
+        }
+    }
+    int genreMovieCount = 0;
+    for (int movie = 1; movie <= set.maxMovie && movie <= genres.maxMovie && rareGenre >= 0; movie++) {
+        if (genres.genres[movie] == 1u << rareGenre) {
+            genreMovies[genreMovieCount++] = movie;
+        }
+    }
+    freeMovieGenres(&genres);
+
+    char copyPath[64];
+    snprintf(copyPath, sizeof(copyPath), "/tmp/kontrol_%d.data", (int)getpid());
+
+    long liveMismatches = -1;
+    long priorMismatches = -1;
+    long cacheMismatches = -1;
+    if (copyFile(ratingsFile, copyPath) == 0) {
+        liveMismatches = checkLive(copyPath, itemsFile, &set, allMovies, set.maxMovie, lines, seed, seedText, NULL);
+    }
+    if (genreMovieCount == 0) {
+        printf("Tek turlu film yok, -p karsilastirmasi atlandi.\n");
+        priorMismatches = 0;
+    } else if (copyFile(ratingsFile, copyPath) == 0) {
+        priorMismatches = checkLive(copyPath, itemsFile, &set, genreMovies, genreMovieCount, lines, seed + 2,
+                                    seedText, KONTROL_PRIOR);
+    }
+    if (copyFile(ratingsFile, copyPath) == 0) {
+        cacheMismatches = checkCache(copyPath, itemsFile, &set, queries, seed, seedText);
+    }
+    remove(copyPath);
+    free(allMovies);
+    free(genreMovies);
+    freeRatingSet(&set);
+    return liveMismatches == 0 && priorMismatches == 0 && cacheMismatches == 0 ? 0 : 1;
+}
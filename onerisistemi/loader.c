@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "loader.h"
+#include "batch.h"
+#include "metrics.h"
+
+// Bu boyuttan küçük dosyalar tek iş parçacığında okunur, iş parçacığı açmaya değmez
+#define PARALLEL_MIN_BYTES (8L << 20)
+
+// Dosyanın salt okunur eşlemesi
+typedef struct MappedFile {
+    const char *data;
+    size_t size;
+} MappedFile;
+
+static int mapFile(const char *fileName, MappedFile *file) {
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return -1;
+    }
+    file->size = (size_t)info.st_size;
+    file->data = NULL;
+    if (file->size > 0) {
+        void *data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(data, file->size, MADV_SEQUENTIAL);
+        file->data = (const char *)data;
+    }
+    close(fd);
+    return 0;
+}
+
+static void unmapFile(MappedFile *file) {
+    if (file->data != NULL) {
+        munmap((void *)file->data, file->size);
+    }
+}
+
+static inline int isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// p'den başlayarak bir sayı okur; satır sonuna (veya end'e) gelmeden sayı bulamazsa 0 döner
+static inline int readUnsigned(const char **p, const char *end, unsigned long *value) {
+    const char *s = *p;
+    while (s < end && !isDigit(*s) && *s != '\n') {
+        s++;
+    }
+    if (s >= end || !isDigit(*s)) {
+        *p = s;
+        return 0;
+    }
+    unsigned long v = 0;
+    while (s < end && isDigit(*s)) {
+        v = v * 10 + (unsigned long)(*s - '0');
+        s++;
+    }
+    *value = v;
+    *p = s;
+    return 1;
+}
+
+static inline const char *skipLine(const char *p, const char *end) {
+    const char *newline = memchr(p, '\n', end - p);
+    return newline ? newline + 1 : end;
+}
+
+// Bir iş parçacığının okuduğu parça
+typedef struct RatingChunk {
+    const char *begin;
+    const char *end;
+    Rating *items;
+    long count;
+    long capacity;
+    int maxUser;
+    int maxMovie;
+} RatingChunk;
+
+// [begin, end) aralığındaki satırları ayrıştırır
+// Satır biçimi: kullanici ayraç film ayraç puan ayraç zaman (ayraç sekme, virgül, boşluk ya da "::")
+// Sayı ile başlamayan satırlar (örneğin CSV başlığı) atlanır. "4.5" gibi puanlar yukarı yuvarlanır.
+static void parseRatingChunk(RatingChunk *chunk) {
+    const char *p = chunk->begin;
+    const char *end = chunk->end;
+    chunk->capacity = (end - p) / 16 + 16;
+    chunk->items = (Rating *)malloc(chunk->capacity * sizeof(Rating));
+    chunk->count = 0;
+    chunk->maxUser = 0;
+    chunk->maxMovie = 0;
+
+    while (p < end) {
+        if (!isDigit(*p)) {
+            p = skipLine(p, end);
+            continue;
+        }
+        unsigned long user, movie, rating, timestamp = 0;
+        if (!readUnsigned(&p, end, &user) || !readUnsigned(&p, end, &movie) || !readUnsigned(&p, end, &rating)) {
+            p = skipLine(p, end);
+            continue;
+        }
+        if (p < end && *p == '.') {  //kesirli puan
+            p++;
+            if (p < end && isDigit(*p) && *p != '0') {
+                rating++;
+            }
+            while (p < end && isDigit(*p)) {
+                p++;
+            }
+        }
+        readUnsigned(&p, end, &timestamp);
+        p = skipLine(p, end);
+
+        if (chunk->count == chunk->capacity) {
+            chunk->capacity *= 2;
+            chunk->items = (Rating *)realloc(chunk->items, chunk->capacity * sizeof(Rating));
+        }
+        Rating *item = &chunk->items[chunk->count++];
+        item->user = (int)user;
+        item->movie = (int)movie;
+        item->rating = (int)rating;
+        item->timestamp = (unsigned int)timestamp;
+        if (item->user > chunk->maxUser) {
+            chunk->maxUser = item->user;
+        }
+        if (item->movie > chunk->maxMovie) {
+            chunk->maxMovie = item->movie;
+        }
+    }
+}
+
+static void *parseRatingChunkThread(void *arg) {
+    parseRatingChunk((RatingChunk *)arg);
+    return NULL;
+}
+
+int loadRatings(const char *fileName, int threads, RatingSet *set) {
+    METRICS_BEGIN(PHASE_PARSE);
+    MappedFile file;
+    if (mapFile(fileName, &file) != 0) {
+        METRICS_END(PHASE_PARSE);  //açılamayan dosya da evrenin çağrı sayısına ve süresine girer
+        return -1;
+    }
+    const char *data = file.data;
+    const char *end = file.data + file.size;
+
+    if (threads <= 0) {
+        threads = file.size < PARALLEL_MIN_BYTES ? 1 : defaultThreadCount();
+    }
+    if (file.size == 0) {
+        threads = 1;
+    }
+
+    // Dosya yaklaşık eşit parçalara bölünür, her parça bir sonraki satır başına kaydırılır
+    RatingChunk *chunks = (RatingChunk *)calloc(threads, sizeof(RatingChunk));
+    const char *begin = data;
+    for (int i = 0; i < threads; i++) {
+        const char *split = (i == threads - 1) ? end : data + file.size / threads * (i + 1);
+        if (split < begin) {
+            split = begin;
+        }
+        if (split < end && split > data && split[-1] != '\n') {
+            split = skipLine(split, end);
+        }
+        chunks[i].begin = begin;
+        chunks[i].end = split;
+        begin = split;
+    }
+
+    if (threads == 1) {
+        parseRatingChunk(&chunks[0]);
+    } else {
+        pthread_t *workers = (pthread_t *)malloc(threads * sizeof(pthread_t));
+        for (int i = 0; i < threads; i++) {
+            pthread_create(&workers[i], NULL, parseRatingChunkThread, &chunks[i]);
+        }
+        for (int i = 0; i < threads; i++) {
+            pthread_join(workers[i], NULL);
+        }
+        free(workers);
+    }
+
+    // Parçalar dosyadaki sırayla birleştirilir
+    long total = 0;
+    for (int i = 0; i < threads; i++) {
+        total += chunks[i].count;
+    }
+    if (threads == 1) {
+        set->items = chunks[0].items;
+    } else {
+        set->items = (Rating *)malloc((total > 0 ? total : 1) * sizeof(Rating));
+        long offset = 0;
+        for (int i = 0; i < threads; i++) {
+            memcpy(set->items + offset, chunks[i].items, chunks[i].count * sizeof(Rating));
+            offset += chunks[i].count;
+            free(chunks[i].items);
+        }
+    }
+    set->count = total;
+    set->maxUser = 0;
+    set->maxMovie = 0;
+    for (int i = 0; i < threads; i++) {
+        if (chunks[i].maxUser > set->maxUser) {
+            set->maxUser = chunks[i].maxUser;
+        }
+        if (chunks[i].maxMovie > set->maxMovie) {
+            set->maxMovie = chunks[i].maxMovie;
+        }
+    }
+
+    free(chunks);
+    unmapFile(&file);
+    METRICS_END(PHASE_PARSE);
+    return 0;
+}
+
+// Bellekteki metni (örneğin izlenen dosyaya yeni eklenmiş satırları) tek iş parçacığında ayrıştırır
+void parseRatingText(const char *text, size_t length, RatingSet *set) {
+    RatingChunk chunk = {text, text + length, NULL, 0, 0, 0, 0};
+    parseRatingChunk(&chunk);
+    set->items = chunk.items;
+    set->count = chunk.count;
+    set->maxUser = chunk.maxUser;
+    set->maxMovie = chunk.maxMovie;
+}
+
+void freeRatingSet(RatingSet *set) {
+    free(set->items);
+    set->items = NULL;
+    set->count = 0;
+}
+
+// u.item satırı: id|isim|tarih|video tarihi|IMDb adresi|19 tür alanı (0/1)
+// Alanlar '|' ile ayrıldığı için sabit bir karakter konumuna değil, 5. ayraçtan sonrasına bakılır.
+#define ITEM_HEADER_FIELDS 5
+#define ITEM_GENRE_FIELDS 19
+
+int loadMovieGenres(const char *fileName, MovieGenres *movies) {
+    METRICS_BEGIN(PHASE_PARSE);
+    MappedFile file;
+    if (mapFile(fileName, &file) != 0) {
+        METRICS_END(PHASE_PARSE);
+        return -1;
+    }
+    const char *p = file.data;
+    const char *end = file.data + file.size;
+
+    int capacity = 2048;
+    movies->genres = (unsigned int *)calloc(capacity, sizeof(unsigned int));
+    movies->maxMovie = 0;
+
+    while (p < end) {
+        const char *lineEnd = memchr(p, '\n', end - p);
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        unsigned long movieId;
+        if (isDigit(*p) && readUnsigned(&p, lineEnd, &movieId)) {
+            int separators = 0;
+            while (p < lineEnd && separators < ITEM_HEADER_FIELDS) {
+                if (*p++ == '|') {
+                    separators++;
+                }
+            }
+            unsigned int mask = 0;
+            for (int g = 0; g < ITEM_GENRE_FIELDS && p < lineEnd; g++) {
+                if (*p == '1') {
+                    mask |= 1u << g;
+                }
+                while (p < lineEnd && *p != '|') {
+                    p++;
+                }
+                p++;
+            }
+
+            if ((int)movieId >= capacity) {
+                int newCapacity = capacity;
+                while ((int)movieId >= newCapacity) {
+                    newCapacity *= 2;
+                }
+                movies->genres = (unsigned int *)realloc(movies->genres, newCapacity * sizeof(unsigned int));
+                memset(movies->genres + capacity, 0, (newCapacity - capacity) * sizeof(unsigned int));
+                capacity = newCapacity;
+            }
+            movies->genres[movieId] = mask;
+            if ((int)movieId > movies->maxMovie) {
+                movies->maxMovie = (int)movieId;
+            }
+        }
+        p = lineEnd + 1;
+    }
+
+    unmapFile(&file);
+    METRICS_END(PHASE_PARSE);
+    return 0;
+}
+
+void freeMovieGenres(MovieGenres *movies) {
+    free(movies->genres);
+    movies->genres = NULL;
+    movies->maxMovie = 0;
+}
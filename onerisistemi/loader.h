@@ -0,0 +1,41 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stddef.h>
+
+// u.data ve u.item dosyalarını bellek eşleme (mmap) ile okuyan ortak yükleyici.
+// fscanf/sscanf yerine elle yazılmış bir tam sayı ayrıştırıcı kullanılır. Büyük dosyalar satır
+// sınırlarından parçalara bölünüp iş parçacıklarında paralel ayrıştırılır, parçalar dosya sırasıyla
+// birleştirildiği için sonuç tek iş parçacıklı okumayla aynıdır.
+
+// Bir puan kaydı (u.data satırı)
+typedef struct Rating {
+    int user;
+    int movie;
+    int rating;
+    unsigned int timestamp;
+} Rating;
+
+typedef struct RatingSet {
+    Rating *items;
+    long count;
+    int maxUser;   //dosyadaki en büyük kullanıcı id'si
+    int maxMovie;  //dosyadaki en büyük film id'si
+} RatingSet;
+
+// Her filmin türleri bit maskesi olarak: genres[movieId] içinde i. bit i. türü gösterir
+typedef struct MovieGenres {
+    unsigned int *genres;  //maxMovie + 1 elemanlı
+    int maxMovie;
+} MovieGenres;
+
+// Başarılıysa 0, dosya açılamazsa -1 döner. threads 0 ise dosya boyutuna ve çekirdek sayısına göre seçilir.
+int loadRatings(const char *fileName, int threads, RatingSet *set);
+void freeRatingSet(RatingSet *set);
+// length baytlık metni aynı kurallarla ayrıştırır; yarım kalan son satır da okunur, çağıran tam satır vermelidir
+void parseRatingText(const char *text, size_t length, RatingSet *set);
+
+int loadMovieGenres(const char *fileName, MovieGenres *movies);
+void freeMovieGenres(MovieGenres *movies);
+
+#endif
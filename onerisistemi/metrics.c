@@ -0,0 +1,116 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "metrics.h"
+
+static const char *phaseNames[PHASE_COUNT] = {
+    "load", "parse", "graph_build", "random", "high_degree", "similar_user", "from_similar_user",
+    "dijkstra", "nearest", "genre", "walk", "item_build", "item", "mf", "trending"
+};
+
+static const char *counterNames[METRIC_COUNT] = {
+    "edges_relaxed", "nodes_settled", "similar_list_nodes", "similar_bit_words", "candidates_scored", "walk_steps"
+};
+
+#ifdef ONERI_METRICS
+
+__thread MetricsBlock *metricsThreadBlock = NULL;
+
+// Yaşayan iş parçacıklarının blokları ve bitmiş olanlardan kalan toplam
+static pthread_mutex_t metricsLock = PTHREAD_MUTEX_INITIALIZER;
+static MetricsBlock *liveBlocks = NULL;
+static MetricsSnapshot retired;
+static pthread_key_t metricsKey;
+static pthread_once_t metricsKeyOnce = PTHREAD_ONCE_INIT;
+
+static void addSnapshot(MetricsSnapshot *total, const MetricsSnapshot *part) {
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        total->phaseCalls[i] += __atomic_load_n(&part->phaseCalls[i], __ATOMIC_RELAXED);
+        total->phaseNanos[i] += __atomic_load_n(&part->phaseNanos[i], __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        total->counters[i] += __atomic_load_n(&part->counters[i], __ATOMIC_RELAXED);
+    }
+}
+
+// İş parçacığı biterken bloğu listeden çıkarılır, değerleri ortak toplama eklenir
+static void retireBlock(void *arg) {
+    MetricsBlock *block = (MetricsBlock *)arg;
+    pthread_mutex_lock(&metricsLock);
+    MetricsBlock **link = &liveBlocks;
+    while (*link != NULL && *link != block) {
+        link = &(*link)->next;
+    }
+    if (*link == block) {
+        *link = block->next;
+    }
+    addSnapshot(&retired, &block->values);
+    pthread_mutex_unlock(&metricsLock);
+    free(block);
+}
+
+static void createMetricsKey(void) {
+    pthread_key_create(&metricsKey, retireBlock);
+}
+
+MetricsBlock *metricsRegisterThread(void) {
+    pthread_once(&metricsKeyOnce, createMetricsKey);
+    MetricsBlock *block = (MetricsBlock *)calloc(1, sizeof(MetricsBlock));
+    pthread_mutex_lock(&metricsLock);
+    block->next = liveBlocks;
+    liveBlocks = block;
+    pthread_mutex_unlock(&metricsLock);
+    pthread_setspecific(metricsKey, block);
+    metricsThreadBlock = block;
+    return block;
+}
+
+long long metricsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void metricsCollect(MetricsSnapshot *snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    pthread_mutex_lock(&metricsLock);
+    addSnapshot(snapshot, &retired);
+    for (MetricsBlock *block = liveBlocks; block != NULL; block = block->next) {
+        addSnapshot(snapshot, &block->values);
+    }
+    pthread_mutex_unlock(&metricsLock);
+}
+
+#else
+
+void metricsCollect(MetricsSnapshot *snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+#endif
+
+void metricsWriteJson(FILE *out, const MetricsSnapshot *snapshot) {
+    fprintf(out, "{\"enabled\": %s, \"phases\": {", METRICS_ENABLED ? "true" : "false");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        fprintf(out, "%s\"%s\": {\"calls\": %lld, \"total_ms\": %.3f}", i == 0 ? "" : ", ", phaseNames[i],
+                snapshot->phaseCalls[i], snapshot->phaseNanos[i] / 1e6);
+    }
+    fprintf(out, "}, \"counters\": {");
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        fprintf(out, "%s\"%s\": %lld", i == 0 ? "" : ", ", counterNames[i], snapshot->counters[i]);
+    }
+    fprintf(out, "}}");
+}
+
+void metricsDump(FILE *out) {
+    if (!METRICS_ENABLED) {
+        return;
+    }
+    MetricsSnapshot snapshot;
+    metricsCollect(&snapshot);
+    fprintf(out, "metrikler: ");
+    metricsWriteJson(out, &snapshot);
+    fprintf(out, "\n");
+}
@@ -0,0 +1,100 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+
+// Sıcak yol ölçümleri: evre (phase) süreleri ve sayaçlar.
+// Sadece -DONERI_METRICS ile derlenince çalışır; normal (release) derlemede makrolar boşa açılır,
+// ölçüm kodu ikili dosyaya hiç girmez.
+//
+// Her iş parçacığı ilk ölçümde kendi bloğunu alır ve sadece ona yazar (kilit ya da atomik toplama yok).
+// metricsCollect tüm blokları o an toplar; biten iş parçacıklarının değerleri kaybolmaz, ortak toplama eklenir.
+
+typedef enum MetricsPhase {
+    PHASE_LOAD,             //veri yükleme (dosya ya da snapshot), ayrıştırma ve kurma dahil
+    PHASE_PARSE,            //u.data / u.item ayrıştırma
+    PHASE_GRAPH_BUILD,      //puan deposunun (kullanıcı-film grafiğinin) kurulması
+    PHASE_RANDOM,           //recommendRandom
+    PHASE_HIGH_DEGREE,      //recommendHighDegree
+    PHASE_SIMILAR_USER,     //findMostSimilarUser
+    PHASE_FROM_SIMILAR,     //recommendFromSimilarUser
+    PHASE_DIJKSTRA,         //dijkstra (seçili yöntem)
+    PHASE_NEAREST,          //recommendNearestMovies (dijkstra dahil)
+    PHASE_GENRE,            //recommend_movies
+    PHASE_WALK,             //random_walk_recommendation
+    PHASE_ITEM_BUILD,       //film-film benzerlik tablosunun kurulması
+    PHASE_ITEM,             //recommendSimilarItems
+    PHASE_MF,               //recommendFactors
+    PHASE_TRENDING,         //recommendTrending
+    PHASE_COUNT
+} MetricsPhase;
+
+typedef enum MetricsCounter {
+    METRIC_EDGES_RELAXED,      //dijkstra'da incelenen (gevşetilmeye çalışılan) kenar
+    METRIC_NODES_SETTLED,      //dijkstra'da kesinleşen düğüm
+    METRIC_SIMILAR_LIST_NODES, //findMostSimilarUser'da gezilen liste düğümü (ters indeks yolu)
+    METRIC_SIMILAR_BIT_WORDS,  //findMostSimilarUser'da AND'lenen 64 bitlik kelime (bit matrisi yolu)
+    METRIC_CANDIDATES_SCORED,  //recommend_movies, recommendSimilarItems, recommendFactors ve recommendTrending'te puanlanan aday film
+    METRIC_WALK_STEPS,         //rastgele yürüyüş adımı
+    METRIC_COUNT
+} MetricsCounter;
+
+typedef struct MetricsSnapshot {
+    long long phaseCalls[PHASE_COUNT];
+    long long phaseNanos[PHASE_COUNT];
+    long long counters[METRIC_COUNT];
+} MetricsSnapshot;
+
+#ifdef ONERI_METRICS
+
+#define METRICS_ENABLED 1
+
+typedef struct MetricsBlock {
+    MetricsSnapshot values;
+    struct MetricsBlock *next;
+} MetricsBlock;
+
+extern __thread MetricsBlock *metricsThreadBlock;
+
+MetricsBlock *metricsRegisterThread(void);
+long long metricsNow(void);
+
+static inline MetricsBlock *metricsBlock(void) {
+    MetricsBlock *block = metricsThreadBlock;
+    return block != NULL ? block : metricsRegisterThread();
+}
+
+// Blok sadece sahibi tarafından yazılır; toplayan iş parçacığı okurken yırtık değer görmesin diye
+// yükleme/saklama atomik ama kilitli toplama (lock add) kullanılmaz.
+static inline void metricsBump(long long *slot, long long amount) {
+    __atomic_store_n(slot, __atomic_load_n(slot, __ATOMIC_RELAXED) + amount, __ATOMIC_RELAXED);
+}
+
+static inline void metricsAddPhase(MetricsPhase phase, long long nanos) {
+    MetricsBlock *block = metricsBlock();
+    metricsBump(&block->values.phaseCalls[phase], 1);
+    metricsBump(&block->values.phaseNanos[phase], nanos);
+}
+
+// METRICS_BEGIN(PHASE_X) ... METRICS_END(PHASE_X) aynı blok içinde kullanılır
+#define METRICS_BEGIN(phase) long long metricsStart_##phase = metricsNow()
+#define METRICS_END(phase) metricsAddPhase(phase, metricsNow() - metricsStart_##phase)
+#define METRICS_ADD(counter, amount) metricsBump(&metricsBlock()->values.counters[counter], (long long)(amount))
+
+#else
+
+#define METRICS_ENABLED 0
+#define METRICS_BEGIN(phase) ((void)0)
+#define METRICS_END(phase) ((void)0)
+#define METRICS_ADD(counter, amount) ((void)0)
+
+#endif
+
+// Tüm iş parçacıklarının (bitmiş olanlar dahil) değerlerini toplar; ölçüm kapalıysa hepsi 0
+void metricsCollect(MetricsSnapshot *snapshot);
+// Toplanmış değerleri tek satırlık JSON olarak yazar (sonunda satır sonu yok)
+void metricsWriteJson(FILE *out, const MetricsSnapshot *snapshot);
+// Toplayıp "metrikler: {...}" satırı olarak yazar; ölçüm kapalıysa hiçbir şey yazmaz
+void metricsDump(FILE *out);
+
+#endif
@@ -0,0 +1,739 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mf.h"
+#include "batch.h"
+#include "metrics.h"
+#include "rng.h"
+#include "snapshot.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(MF_NO_AVX2)
+#include <immintrin.h>
+#define MF_HAVE_AVX2 1
+#endif
+
+#define MF_MAGIC "ONERIMF1"
+#define MF_VERSION 2
+#define MF_BYTE_ORDER 0x01020304u
+#define MF_SECTION_ALIGN 64
+#define MF_INIT_SCALE 0.1   //vektörlerin ilk değerleri [-0.1, 0.1] aralığında
+#define ALS_BLOCK 64        //als'de bir iş parçacığının bir seferde aldığı kullanıcı/film sayısı
+
+#if MF_FACTORS % 8 != 0
+#error "MF_FACTORS 8'in katı olmalı"
+#endif
+
+typedef enum FactorSection {
+    FACTOR_USER_BIAS,
+    FACTOR_MOVIE_BIAS,
+    FACTOR_USER_VECTORS,
+    FACTOR_MOVIE_VECTORS,
+    FACTOR_SECTION_COUNT
+} FactorSection;
+
+// Model dosyası: başlık, ardından 64 bayta hizalı dört bölüm (snapshot ile aynı düzen)
+typedef struct FactorFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    int32_t users;
+    int32_t movies;
+    int32_t factors;
+    float globalMean;
+    int64_t ratings;     //eğitildiği verinin puan sayısı ve özeti (bkz. ratingFingerprint)
+    uint64_t dataHash;
+    uint64_t sectionOffset[FACTOR_SECTION_COUNT];
+    uint64_t fileSize;
+    uint64_t checksum;   //bu alan sıfırken başlık dahil tüm dosyanın sağlama toplamı
+} FactorFileHeader;
+
+#define FACTOR_HEADER_AREA ((sizeof(FactorFileHeader) + MF_SECTION_ALIGN - 1) & ~(uint64_t)(MF_SECTION_ALIGN - 1))
+
+// Eğitimde puanlar (kullanıcı, film, puan) üçlüleri olarak karıştırılıp gezilir
+typedef struct MfSample {
+    int user;
+    int movie;
+    float rating;
+} MfSample;
+
+static float *allocVectors(long rows) {
+    size_t size = (size_t)rows * MF_FACTORS * sizeof(float);
+    size_t rounded = (size + 63) & ~(size_t)63;
+    float *vectors = (float *)aligned_alloc(64, rounded ? rounded : 64);
+    memset(vectors, 0, rounded);
+    return vectors;
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Çekirdekler: iç çarpım, sgd adımı, als toplamları ve bir kullanıcı için tüm filmlerin puanı
+
+static float dotScalar(const float *a, const float *b) {
+    float sums[8] = {0};
+    for (int f = 0; f < MF_FACTORS; f += 8) {
+        for (int i = 0; i < 8; i++) {
+            sums[i] += a[f + i] * b[f + i];
+        }
+    }
+    return ((sums[0] + sums[4]) + (sums[1] + sums[5])) + ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+}
+
+static void stepScalar(float *p, float *q, float error, float rate, float regularization) {
+    for (int f = 0; f < MF_FACTORS; f++) {
+        float pf = p[f];
+        float qf = q[f];
+        p[f] = pf + rate * (error * qf - regularization * pf);
+        q[f] = qf + rate * (error * pf - regularization * qf);
+    }
+}
+
+// als: a += v v^T (tam kare, MF_FACTORS x MF_FACTORS), b += v * residual
+static void accumulateScalar(float *a, float *b, const float *v, float residual) {
+    for (int r = 0; r < MF_FACTORS; r++) {
+        float vr = v[r];
+        b[r] += vr * residual;
+        for (int c = 0; c < MF_FACTORS; c++) {
+            a[r * MF_FACTORS + c] += vr * v[c];
+        }
+    }
+}
+
+static void scoreScalar(const float *user, const float *vectors, const float *bias, int movies, float *scores) {
+    for (int m = 0; m < movies; m++) {
+        scores[m] = bias[m] + dotScalar(user, vectors + (long)m * MF_FACTORS);
+    }
+}
+
+#ifdef MF_HAVE_AVX2
+// AVX2 sürümleri: vektörler 64 bayta hizalı olduğu için hizalı 8'li float yükleme, çarpıp toplama FMA ile
+__attribute__((target("avx2,fma")))
+static inline float dotAvx2(const float *a, const float *b) {
+    __m256 sum = _mm256_mul_ps(_mm256_load_ps(a), _mm256_load_ps(b));
+    for (int f = 8; f < MF_FACTORS; f += 8) {
+        sum = _mm256_fmadd_ps(_mm256_load_ps(a + f), _mm256_load_ps(b + f), sum);
+    }
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_movehdup_ps(half));
+    return _mm_cvtss_f32(half);
+}
+
+__attribute__((target("avx2,fma")))
+static float dotAvx2Call(const float *a, const float *b) {
+    return dotAvx2(a, b);
+}
+
+__attribute__((target("avx2,fma")))
+static void stepAvx2(float *p, float *q, float error, float rate, float regularization) {
+    const __m256 e = _mm256_set1_ps(error);
+    const __m256 a = _mm256_set1_ps(rate);
+    const __m256 l = _mm256_set1_ps(regularization);
+    for (int f = 0; f < MF_FACTORS; f += 8) {
+        __m256 pf = _mm256_load_ps(p + f);
+        __m256 qf = _mm256_load_ps(q + f);
+        __m256 gradP = _mm256_fmsub_ps(e, qf, _mm256_mul_ps(l, pf));
+        __m256 gradQ = _mm256_fmsub_ps(e, pf, _mm256_mul_ps(l, qf));
+        _mm256_store_ps(p + f, _mm256_fmadd_ps(a, gradP, pf));
+        _mm256_store_ps(q + f, _mm256_fmadd_ps(a, gradQ, qf));
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void accumulateAvx2(float *a, float *b, const float *v, float residual) {
+    const __m256 res = _mm256_set1_ps(residual);
+    for (int c = 0; c < MF_FACTORS; c += 8) {
+        _mm256_store_ps(b + c, _mm256_fmadd_ps(_mm256_load_ps(v + c), res, _mm256_load_ps(b + c)));
+    }
+    for (int r = 0; r < MF_FACTORS; r++) {
+        const __m256 vr = _mm256_set1_ps(v[r]);
+        float *row = a + r * MF_FACTORS;
+        for (int c = 0; c < MF_FACTORS; c += 8) {
+            _mm256_store_ps(row + c, _mm256_fmadd_ps(vr, _mm256_load_ps(v + c), _mm256_load_ps(row + c)));
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void scoreAvx2(const float *user, const float *vectors, const float *bias, int movies, float *scores) {
+    for (int m = 0; m < movies; m++) {
+        scores[m] = bias[m] + dotAvx2(user, vectors + (long)m * MF_FACTORS);
+    }
+}
+#endif
+
+typedef struct MfKernels {
+    float (*dot)(const float *a, const float *b);
+    void (*step)(float *p, float *q, float error, float rate, float regularization);
+    void (*accumulate)(float *a, float *b, const float *v, float residual);
+    void (*score)(const float *user, const float *vectors, const float *bias, int movies, float *scores);
+} MfKernels;
+
+static const MfKernels scalarKernels = {dotScalar, stepScalar, accumulateScalar, scoreScalar};
+#ifdef MF_HAVE_AVX2
+static const MfKernels avx2Kernels = {dotAvx2Call, stepAvx2, accumulateAvx2, scoreAvx2};
+#endif
+
+// İşlemciye göre çekirdek seçilir
+static const MfKernels *selectKernels(void) {
+#ifdef MF_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return &avx2Kernels;
+    }
+#endif
+    return &scalarKernels;
+}
+
+int mfKernelUsesAvx2(void) {
+#ifdef MF_HAVE_AVX2
+    return selectKernels() == &avx2Kernels;
+#else
+    return 0;
+#endif
+}
+
+static FactorModel *allocateModel(int users, int movies) {
+    FactorModel *model = (FactorModel *)calloc(1, sizeof(FactorModel));
+    model->users = users;
+    model->movies = movies;
+    model->userBias = (float *)calloc(users, sizeof(float));
+    model->movieBias = (float *)calloc(movies, sizeof(float));
+    model->userFactors = allocVectors(users);
+    model->movieFactors = allocVectors(movies);
+    return model;
+}
+
+static void randomVectors(float *vectors, long rows, Rng *rng) {
+    for (long i = 0; i < rows * MF_FACTORS; i++) {
+        double unit = (rngNext(rng) >> 11) * (1.0 / 9007199254740992.0);  //[0, 1)
+        vectors[i] = (float)((2 * unit - 1) * MF_INIT_SCALE);
+    }
+}
+
+static void runWorkers(int threads, void *(*worker)(void *), void *states, size_t stateSize) {
+    pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&ids[i], NULL, worker, (char *)states + i * stateSize);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    free(ids);
+}
+
+// sgd: her iş parçacığı puanların kendi parçasını karıştırıp gezer, vektörler kilitsiz güncellenir
+
+typedef struct SgdWorker {
+    FactorModel *model;
+    MfSample *samples;
+    long first;
+    long last;
+    float rate;
+    float regularization;
+    unsigned long long seed;
+    double squaredError;
+} SgdWorker;
+
+static void *sgdWorker(void *arg) {
+    SgdWorker *worker = (SgdWorker *)arg;
+    FactorModel *model = worker->model;
+    const MfKernels *kernels = selectKernels();
+    MfSample *samples = worker->samples + worker->first;
+    long count = worker->last - worker->first;
+
+    Rng rng;
+    rngSeed(&rng, worker->seed);
+    for (long i = count - 1; i > 0; i--) {
+        long j = (long)((rngNext(&rng) >> 33) % (unsigned long long)(i + 1));
+        MfSample swap = samples[i];
+        samples[i] = samples[j];
+        samples[j] = swap;
+    }
+
+    float rate = worker->rate;
+    float regularization = worker->regularization;
+    double squaredError = 0;
+    for (long i = 0; i < count; i++) {
+        int user = samples[i].user;
+        int movie = samples[i].movie;
+        float *p = model->userFactors + (long)user * MF_FACTORS;
+        float *q = model->movieFactors + (long)movie * MF_FACTORS;
+        float error = samples[i].rating - (model->globalMean + model->userBias[user] + model->movieBias[movie] +
+                                           kernels->dot(p, q));
+        squaredError += (double)error * error;
+        model->userBias[user] += rate * (error - regularization * model->userBias[user]);
+        model->movieBias[movie] += rate * (error - regularization * model->movieBias[movie]);
+        kernels->step(p, q, error, rate, regularization);
+    }
+    worker->squaredError = squaredError;
+    return NULL;
+}
+
+static void trainSgd(FactorModel *model, const RatingMatrix *matrix, const MfConfig *config, int threads, MfEpoch *epochs) {
+    long count = matrix->nonZeros;
+    MfSample *samples = (MfSample *)malloc(count * sizeof(MfSample));
+    long n = 0;
+    for (int u = 0; u < matrix->users; u++) {
+        for (long p = matrix->rowOffsets[u]; p < matrix->rowEnds[u]; p++) {
+            samples[n].user = u;
+            samples[n].movie = matrix->rowMovies[p];
+            samples[n].rating = matrix->rowRatings[p];
+            n++;
+        }
+    }
+    // Parçalar kullanıcı sırasında kalmasın diye önce tüm puanlar bir kez karıştırılır
+    Rng rng;
+    rngSeed(&rng, config->seed);
+    for (long i = n - 1; i > 0; i--) {
+        long j = (long)((rngNext(&rng) >> 33) % (unsigned long long)(i + 1));
+        MfSample swap = samples[i];
+        samples[i] = samples[j];
+        samples[j] = swap;
+    }
+
+    SgdWorker *workers = (SgdWorker *)malloc(threads * sizeof(SgdWorker));
+    double rate = config->learningRate;
+    for (int epoch = 0; epoch < config->epochs; epoch++) {
+        double start = nowSeconds();
+        for (int i = 0; i < threads; i++) {
+            workers[i].model = model;
+            workers[i].samples = samples;
+            workers[i].first = n * i / threads;
+            workers[i].last = n * (i + 1) / threads;
+            workers[i].rate = (float)rate;
+            workers[i].regularization = (float)config->regularization;
+            workers[i].seed = config->seed ^ (0x9E3779B97F4A7C15ULL * (unsigned long long)(epoch * threads + i + 1));
+        }
+        runWorkers(threads, sgdWorker, workers, sizeof(SgdWorker));
+        double squaredError = 0;
+        for (int i = 0; i < threads; i++) {
+            squaredError += workers[i].squaredError;
+        }
+        if (epochs != NULL) {
+            epochs[epoch].seconds = nowSeconds() - start;
+            epochs[epoch].rmse = n > 0 ? sqrt(squaredError / n) : 0.0;  //tur sırasında, güncellemeden önceki hata
+        }
+        rate *= MF_DECAY;
+    }
+    free(workers);
+    free(samples);
+}
+
+// als: bir taraf sabitken diğer taraftaki her vektör kendi k x k sisteminin çözümüdür
+
+typedef struct AlsState {
+    FactorModel *model;
+    const RatingMatrix *matrix;
+    int solveMovies;       //0: kullanıcı vektörleri, 1: film vektörleri çözülür
+    int next;              //sıradaki blok, atomik olarak artırılır
+    float regularization;
+} AlsState;
+
+typedef struct AlsWorker {
+    AlsState *state;
+    double squaredError;   //film turunda, çözülen vektörle hesaplanan hata
+} AlsWorker;
+
+// A x = b, A simetrik pozitif tanımlı (Cholesky: A = L L^T, L A'nın alt üçgenine yazılır)
+static void choleskySolve(double *a, double *b, int n) {
+    for (int j = 0; j < n; j++) {
+        double diagonal = a[j * n + j];
+        for (int k = 0; k < j; k++) {
+            diagonal -= a[j * n + k] * a[j * n + k];
+        }
+        diagonal = sqrt(diagonal > 1e-12 ? diagonal : 1e-12);
+        a[j * n + j] = diagonal;
+        for (int i = j + 1; i < n; i++) {
+            double sum = a[i * n + j];
+            for (int k = 0; k < j; k++) {
+                sum -= a[i * n + k] * a[j * n + k];
+            }
+            a[i * n + j] = sum / diagonal;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        double sum = b[i];
+        for (int k = 0; k < i; k++) {
+            sum -= a[i * n + k] * b[k];
+        }
+        b[i] = sum / a[i * n + i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        double sum = b[i];
+        for (int k = i + 1; k < n; k++) {
+            sum -= a[k * n + i] * b[k];
+        }
+        b[i] = sum / a[i * n + i];
+    }
+}
+
+static void *alsWorker(void *arg) {
+    AlsWorker *worker = (AlsWorker *)arg;
+    AlsState *state = worker->state;
+    FactorModel *model = state->model;
+    const RatingMatrix *matrix = state->matrix;
+    const MfKernels *kernels = selectKernels();
+    int count = state->solveMovies ? matrix->movies : matrix->users;
+    float *solved = state->solveMovies ? model->movieFactors : model->userFactors;
+    const float *fixed = state->solveMovies ? model->userFactors : model->movieFactors;
+    // Toplamlar float olarak 8'li vektörlerle biriktirilir, çözüm double ile yapılır
+    float sumA[MF_FACTORS * MF_FACTORS] __attribute__((aligned(64)));
+    float sumB[MF_FACTORS] __attribute__((aligned(64)));
+    double a[MF_FACTORS * MF_FACTORS];
+    double b[MF_FACTORS];
+    double squaredError = 0;
+
+    for (;;) {
+        int first = __atomic_fetch_add(&state->next, ALS_BLOCK, __ATOMIC_RELAXED);
+        if (first >= count) {
+            break;
+        }
+        int last = first + ALS_BLOCK < count ? first + ALS_BLOCK : count;
+        for (int x = first; x < last; x++) {
+            int length;
+            const int *others;
+            const unsigned char *ratings;
+            if (state->solveMovies) {
+                others = movieColumn(matrix, x, &length);
+                ratings = matrix->colRatings + matrix->colOffsets[x];
+            } else {
+                others = userRow(matrix, x, &length);
+                ratings = matrix->rowRatings + matrix->rowOffsets[x];
+            }
+            float *target = solved + (long)x * MF_FACTORS;
+            if (length == 0) {
+                memset(target, 0, MF_FACTORS * sizeof(float));
+                continue;
+            }
+
+            memset(sumA, 0, sizeof(sumA));
+            memset(sumB, 0, sizeof(sumB));
+            for (int j = 0; j < length; j++) {
+                int user = state->solveMovies ? others[j] : x;
+                int movie = state->solveMovies ? x : others[j];
+                float residual = ratings[j] - model->globalMean - model->userBias[user] - model->movieBias[movie];
+                kernels->accumulate(sumA, sumB, fixed + (long)others[j] * MF_FACTORS, residual);
+            }
+            for (int r = 0; r < MF_FACTORS; r++) {
+                for (int c = 0; c <= r; c++) {  //alt üçgen yeterli
+                    a[r * MF_FACTORS + c] = sumA[r * MF_FACTORS + c];
+                }
+                a[r * MF_FACTORS + r] += (double)state->regularization * length;
+                b[r] = sumB[r];
+            }
+            choleskySolve(a, b, MF_FACTORS);
+            for (int r = 0; r < MF_FACTORS; r++) {
+                target[r] = (float)b[r];
+            }
+
+            if (state->solveMovies) {
+                for (int j = 0; j < length; j++) {
+                    int user = others[j];
+                    float error = ratings[j] - (model->globalMean + model->userBias[user] + model->movieBias[x] +
+                                                kernels->dot(fixed + (long)user * MF_FACTORS, target));
+                    squaredError += (double)error * error;
+                }
+            }
+        }
+    }
+    worker->squaredError = squaredError;
+    return NULL;
+}
+
+static void trainAls(FactorModel *model, const RatingMatrix *matrix, const MfConfig *config, int threads, MfEpoch *epochs) {
+    // Sapmalar: önce filmlerin, sonra kullanıcıların MF_BIAS_PRIOR ile küçültülmüş ortalama sapması
+    for (int m = 0; m < matrix->movies; m++) {
+        int raters;
+        movieColumn(matrix, m, &raters);
+        double sum = 0;
+        const unsigned char *ratings = matrix->colRatings + matrix->colOffsets[m];
+        for (int j = 0; j < raters; j++) {
+            sum += ratings[j] - model->globalMean;
+        }
+        model->movieBias[m] = (float)(sum / (MF_BIAS_PRIOR + raters));
+    }
+    for (int u = 0; u < matrix->users; u++) {
+        int length;
+        const int *movies = userRow(matrix, u, &length);
+        const unsigned char *ratings = matrix->rowRatings + matrix->rowOffsets[u];
+        double sum = 0;
+        for (int j = 0; j < length; j++) {
+            sum += ratings[j] - model->globalMean - model->movieBias[movies[j]];
+        }
+        model->userBias[u] = (float)(sum / (MF_BIAS_PRIOR + length));
+    }
+
+    AlsWorker *workers = (AlsWorker *)malloc(threads * sizeof(AlsWorker));
+    for (int epoch = 0; epoch < config->epochs; epoch++) {
+        double start = nowSeconds();
+        double squaredError = 0;
+        for (int side = 0; side < 2; side++) {
+            AlsState state = {model, matrix, side, 0, (float)config->regularization};
+            for (int i = 0; i < threads; i++) {
+                workers[i].state = &state;
+                workers[i].squaredError = 0;
+            }
+            runWorkers(threads, alsWorker, workers, sizeof(AlsWorker));
+            for (int i = 0; i < threads; i++) {
+                squaredError += workers[i].squaredError;
+            }
+        }
+        if (epochs != NULL) {
+            epochs[epoch].seconds = nowSeconds() - start;
+            epochs[epoch].rmse = matrix->nonZeros > 0 ? sqrt(squaredError / matrix->nonZeros) : 0.0;
+        }
+    }
+    free(workers);
+}
+
+// Verinin özeti: satır sırasıyla tüm (kullanıcı, film, puan) üçlüleri. Satır dizilerinin boyundan ve
+// sonda puansız kullanıcılardan bağımsızdır; dosyadan, snapshot'tan ya da büyüyebilen kopyadan aynı çıkar.
+static uint64_t ratingFingerprint(const RatingMatrix *matrix) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int user = 0; user < matrix->users; user++) {
+        for (long i = matrix->rowOffsets[user]; i < matrix->rowEnds[user]; i++) {
+            uint64_t word = ((uint64_t)(uint32_t)user << 32) ^ ((uint64_t)(uint32_t)matrix->rowMovies[i] << 3) ^ matrix->rowRatings[i];
+            hash = (hash ^ word) * 0x100000001b3ULL;
+            hash ^= hash >> 29;
+        }
+    }
+    return hash;
+}
+
+FactorModel *trainFactorModel(const RatingMatrix *matrix, const MfConfig *config, MfEpoch *epochs) {
+    FactorModel *model = allocateModel(matrix->users, matrix->movies);
+    model->globalMean = matrix->totalCount > 0 ? (float)((double)matrix->totalSum / matrix->totalCount) : 0.0f;
+    model->ratings = matrix->nonZeros;
+    model->dataHash = ratingFingerprint(matrix);
+    Rng rng;
+    rngSeed(&rng, config->seed);
+    randomVectors(model->userFactors, model->users, &rng);
+    randomVectors(model->movieFactors, model->movies, &rng);
+
+    int threads = config->threads > 0 ? config->threads : defaultThreadCount();
+    if (config->method == MF_ALS) {
+        trainAls(model, matrix, config, threads, epochs);
+    } else {
+        trainSgd(model, matrix, config, threads, epochs);
+    }
+    return model;
+}
+
+void freeFactorModel(FactorModel *model) {
+    if (model == NULL) {
+        return;
+    }
+    if (model->base != NULL) {
+        munmap(model->base, model->size);
+    } else {
+        free(model->userBias);
+        free(model->movieBias);
+        free(model->userFactors);
+        free(model->movieFactors);
+    }
+    free(model);
+}
+
+// Başlık alanı checksum alanı sıfırlanmış haliyle, bölümler olduğu gibi özetlenir
+static uint64_t factorChecksum(const unsigned char *image, uint64_t fileSize) {
+    unsigned char headerArea[FACTOR_HEADER_AREA];
+    memcpy(headerArea, image, sizeof(headerArea));
+    memset(headerArea + offsetof(FactorFileHeader, checksum), 0, sizeof(uint64_t));
+    uint64_t hash = checksumBytes(headerArea, sizeof(headerArea));
+    return (hash * 0x100000001b3ULL) ^ checksumBytes(image + sizeof(headerArea), fileSize - sizeof(headerArea));
+}
+
+int writeFactorModel(const char *path, const FactorModel *model) {
+    const void *sources[FACTOR_SECTION_COUNT] = {model->userBias, model->movieBias, model->userFactors, model->movieFactors};
+    uint64_t sizes[FACTOR_SECTION_COUNT] = {
+        (uint64_t)model->users * sizeof(float), (uint64_t)model->movies * sizeof(float),
+        (uint64_t)model->users * MF_FACTORS * sizeof(float), (uint64_t)model->movies * MF_FACTORS * sizeof(float)
+    };
+
+    FactorFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MF_MAGIC, 8);
+    header.version = MF_VERSION;
+    header.byteOrder = MF_BYTE_ORDER;
+    header.users = model->users;
+    header.movies = model->movies;
+    header.factors = MF_FACTORS;
+    header.globalMean = model->globalMean;
+    header.ratings = model->ratings;
+    header.dataHash = model->dataHash;
+    uint64_t offset = FACTOR_HEADER_AREA;
+    for (int i = 0; i < FACTOR_SECTION_COUNT; i++) {
+        header.sectionOffset[i] = offset;
+        offset = (offset + sizes[i] + MF_SECTION_ALIGN - 1) & ~(uint64_t)(MF_SECTION_ALIGN - 1);
+    }
+    header.fileSize = offset;
+
+    unsigned char *image = (unsigned char *)calloc(1, header.fileSize);
+    if (image == NULL) {
+        printf("Model icin bellek ayrilamadi.\n");
+        return -1;
+    }
+    for (int i = 0; i < FACTOR_SECTION_COUNT; i++) {
+        memcpy(image + header.sectionOffset[i], sources[i], sizes[i]);
+    }
+    memcpy(image, &header, sizeof(header));
+    header.checksum = factorChecksum(image, header.fileSize);
+    memcpy(image, &header, sizeof(header));
+
+    // Yarım yazılmış bir model açılmasın diye önce geçici dosyaya yazılıp sonra adı değiştirilir
+    char tempPath[4096];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL) {
+        printf("Model dosyasi acilamadi: %s\n", tempPath);
+        free(image);
+        return -1;
+    }
+    size_t written = fwrite(image, 1, header.fileSize, file);
+    int closed = fclose(file);
+    free(image);
+    if (written != header.fileSize || closed != 0 || rename(tempPath, path) != 0) {
+        printf("Model yazilamadi: %s\n", path);
+        remove(tempPath);
+        return -1;
+    }
+    return 0;
+}
+
+// Bölümler başlıktan hemen sonra başlayıp sırayla, hizalı ve birbirine binmeden dizilmeli;
+// her biri kullanıcı/film sayısından beklenen boyutu taşımalı
+static int factorSectionsFit(const FactorFileHeader *header) {
+    uint64_t sizes[FACTOR_SECTION_COUNT] = {
+        (uint64_t)header->users * sizeof(float), (uint64_t)header->movies * sizeof(float),
+        (uint64_t)header->users * MF_FACTORS * sizeof(float), (uint64_t)header->movies * MF_FACTORS * sizeof(float)
+    };
+    if (header->sectionOffset[0] != FACTOR_HEADER_AREA) {
+        return 0;
+    }
+    uint64_t end = FACTOR_HEADER_AREA;
+    for (int i = 0; i < FACTOR_SECTION_COUNT; i++) {
+        uint64_t offset = header->sectionOffset[i];
+        if (offset % MF_SECTION_ALIGN != 0 || offset < end || offset > header->fileSize ||
+            sizes[i] > header->fileSize - offset) {
+            return 0;
+        }
+        end = offset + sizes[i];
+    }
+    return 1;
+}
+
+FactorModel *loadFactorModel(const char *path, const RatingMatrix *matrix) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Model dosyasi acilamadi: %s\n", path);
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (uint64_t)info.st_size < FACTOR_HEADER_AREA) {
+        printf("Model dosyasi gecersiz: %s\n", path);
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("Model dosyasi eslenemedi: %s\n", path);
+        return NULL;
+    }
+
+    const FactorFileHeader *header = (const FactorFileHeader *)base;
+    const char *error = NULL;
+    if (memcmp(header->magic, MF_MAGIC, 8) != 0) {
+        error = "model dosyasi degil";
+    } else if (header->version != MF_VERSION) {
+        error = "surum uyusmuyor";
+    } else if (header->byteOrder != MF_BYTE_ORDER) {
+        error = "bayt sirasi uyusmuyor";
+    } else if (header->fileSize != (uint64_t)info.st_size) {
+        error = "dosya boyutu uyusmuyor";
+    } else if (header->factors != MF_FACTORS) {
+        error = "faktor sayisi uyusmuyor";
+    } else if (header->users <= 0 || header->movies <= 0 || !factorSectionsFit(header)) {
+        error = "bolum tablosu gecersiz";
+    } else if (factorChecksum((const unsigned char *)base, header->fileSize) != header->checksum) {
+        error = "saglama toplami tutmuyor";
+    } else if (header->users > matrix->users || header->movies > matrix->movies ||
+               header->ratings != matrix->nonZeros || header->dataHash != ratingFingerprint(matrix)) {
+        error = "model baska bir veriyle egitilmis";
+    }
+    if (error != NULL) {
+        printf("Model reddedildi (%s): %s\n", error, path);
+        munmap(base, (size_t)info.st_size);
+        return NULL;
+    }
+
+    char *bytes = (char *)base;
+    FactorModel *model = (FactorModel *)calloc(1, sizeof(FactorModel));
+    model->users = header->users;
+    model->movies = header->movies;
+    model->globalMean = header->globalMean;
+    model->ratings = (long)header->ratings;
+    model->dataHash = header->dataHash;
+    model->userBias = (float *)(bytes + header->sectionOffset[FACTOR_USER_BIAS]);
+    model->movieBias = (float *)(bytes + header->sectionOffset[FACTOR_MOVIE_BIAS]);
+    model->userFactors = (float *)(bytes + header->sectionOffset[FACTOR_USER_VECTORS]);
+    model->movieFactors = (float *)(bytes + header->sectionOffset[FACTOR_MOVIE_VECTORS]);
+    model->base = base;
+    model->size = (size_t)info.st_size;
+    return model;
+}
+
+float predictRating(const FactorModel *model, int user, int movie) {
+    return model->globalMean + model->userBias[user] + model->movieBias[movie] +
+           selectKernels()->dot(model->userFactors + (long)user * MF_FACTORS, model->movieFactors + (long)movie * MF_FACTORS);
+}
+
+FactorScratch *createFactorScratch(int movies) {
+    FactorScratch *scratch = (FactorScratch *)malloc(sizeof(FactorScratch));
+    scratch->scores = (float *)malloc(movies * sizeof(float));
+    scratch->items = (ScoredItem *)malloc(movies * sizeof(ScoredItem));
+    return scratch;
+}
+
+void freeFactorScratch(FactorScratch *scratch) {
+    free(scratch->scores);
+    free(scratch->items);
+    free(scratch);
+}
+
+int recommendFactors(const FactorModel *model, const RatingMatrix *matrix, int user, int rec,
+                     FactorScratch *scratch, int *out) {
+    if (user - 1 >= model->users) {
+        return 0;  //modelden sonra gelen kullanıcı
+    }
+    METRICS_BEGIN(PHASE_MF);
+    int movies = model->movies < matrix->movies ? model->movies : matrix->movies;
+    selectKernels()->score(model->userFactors + (long)(user - 1) * MF_FACTORS, model->movieFactors, model->movieBias,
+                           movies, scratch->scores);
+    METRICS_ADD(METRIC_CANDIDATES_SCORED, movies);
+
+    TopK topk;
+    topkInit(&topk, scratch->items, rec);
+    for (int m = 0; m < movies; m++) {
+        if (!hasRated(matrix, user - 1, m)) {
+            topkPush(&topk, m + 1, scratch->scores[m]);
+        }
+    }
+    int count = topkFinish(&topk);
+    for (int k = 0; k < count; k++) {
+        out[k] = scratch->items[k].id;
+    }
+    METRICS_END(PHASE_MF);
+    return count;
+}
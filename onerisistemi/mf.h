@@ -0,0 +1,98 @@
+#ifndef MF_H
+#define MF_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "bitmatrix.h"
+#include "topk.h"
+
+// Gizil faktör modeli (matrix factorization): her kullanıcı ve film için MF_FACTORS boyutlu vektör ve sapma.
+//   tahmin(u, i) = m + b_u + b_i + p_u . q_i
+// m tüm puanların ortalaması, b_u / b_i kullanıcının ve filmin ortalamadan sapmasıdır.
+//
+// İki eğitim yöntemi vardır:
+// sgd: puanlar karıştırılıp sırayla gezilir, her puanda hata e = r - tahmin ile
+//   b_u += a (e - l b_u), b_i += a (e - l b_i), p_u += a (e q_i - l p_u), q_i += a (e p_u - l q_i).
+//   Puanlar iş parçacıklarına parça parça dağıtılır ve vektörler kilitsiz güncellenir (Hogwild): iki iş
+//   parçacığının aynı vektöre aynı anda yazması seyrek puanlarda nadirdir ve yakınsamayı bozmaz. Bu yüzden
+//   birden çok iş parçacığıyla sonuç çalıştırmadan çalıştırmaya az da olsa değişir; tek iş parçacığında sabittir.
+// als: sapmalar önce bir kez (küçültülmüş ortalamalarla) bulunur, sonra q sabitken her p_u, p sabitken her q_i
+//   kalan puanlar (r - m - b_u - b_i) üzerinde en küçük kareler çözümüyle bulunur:
+//   (sum q q^T + l n_u I) p_u = sum q (r - m - b_u - b_i). Çözümler birbirinden bağımsızdır, paralel yapılır.
+//
+// Vektörler sabit genişliktedir ve 64 bayta hizalıdır; iç çarpım ve güncellemeler AVX2/FMA destekleyen
+// işlemcide 8'li float vektörlerle, yoksa skaler yapılır (seçim çalışma anında, bkz. mfKernelUsesAvx2).
+// Model egit ile bir kez eğitilip dosyaya yazılır; oneri1, sunucu ve olcum -M ile dosyayı mmap ile açar,
+// sunarken hiç eğitim yapılmaz. Canlı modda model güncellenmez; yeni izlenen filmler sadece öneriden çıkar.
+
+#ifndef MF_FACTORS
+#define MF_FACTORS 32  //8'in katı olmalı
+#endif
+
+#define MF_BIAS_PRIOR 10.0  //als'de sapmaları sıfıra çeken sanal puan sayısı
+
+typedef enum MfMethod {
+    MF_SGD,
+    MF_ALS
+} MfMethod;
+
+typedef struct MfConfig {
+    MfMethod method;
+    int epochs;
+    int threads;           //0 ise çekirdek sayısı kadar
+    double learningRate;   //sadece sgd, her turda MF_DECAY ile çarpılır
+    double regularization;
+    unsigned long long seed;
+} MfConfig;
+
+#define MF_DECAY 0.95
+
+// Tur başına eğitim süresi ve eğitim puanları üzerindeki hata (RMSE)
+typedef struct MfEpoch {
+    double seconds;
+    double rmse;
+} MfEpoch;
+
+// Kullanıcı ve film 0 tabanlı. Vektör satırları MF_FACTORS float'tır.
+typedef struct FactorModel {
+    int users;
+    int movies;
+    float globalMean;
+    long ratings;          //eğitildiği verinin puan sayısı ve özeti; yüklenen model bunlar tutmazsa reddedilir
+    uint64_t dataHash;
+    float *userBias;       //users
+    float *movieBias;      //movies
+    float *userFactors;    //users * MF_FACTORS
+    float *movieFactors;   //movies * MF_FACTORS
+    void *base;            //dosyadan açıldıysa eşleme, diziler onun içini gösterir; eğitildiyse NULL
+    size_t size;
+} FactorModel;
+
+// Sorgu başına çalışma alanı (iş parçacığı başına bir tane)
+typedef struct FactorScratch {
+    float *scores;         //movies
+    ScoredItem *items;     //movies
+} FactorScratch;
+
+// epochs verilirse config->epochs elemanlı olmalı, her turun süresi ve hatası yazılır
+FactorModel *trainFactorModel(const RatingMatrix *matrix, const MfConfig *config, MfEpoch *epochs);
+void freeFactorModel(FactorModel *model);
+// Başarılıysa 0, hata olursa -1 döner ve hata mesajı yazılır
+int writeFactorModel(const char *path, const FactorModel *model);
+// Model matrix'in puanlarıyla eğitilmemişse (puan sayısı ya da özeti tutmuyorsa) reddedilir, NULL döner ve
+// mesaj yazılır. Kontrol açılışta yapılır; canlı modda sonradan eklenen puanlar modeli geçersiz saymaz.
+FactorModel *loadFactorModel(const char *path, const RatingMatrix *matrix);
+
+float predictRating(const FactorModel *model, int user, int movie);
+int mfKernelUsesAvx2(void);
+
+FactorScratch *createFactorScratch(int movies);
+void freeFactorScratch(FactorScratch *scratch);
+
+// Kullanıcının izlemediği tüm filmler tek geçişte puanlanır (b_i + p_u . q_i; m ve b_u sıralamayı değiştirmez),
+// en iyi rec tanesi seçilir. Kullanıcı ve dönen filmler 1 tabanlıdır, öneri sayısı döner.
+int recommendFactors(const FactorModel *model, const RatingMatrix *matrix, int user, int rec,
+                     FactorScratch *scratch, int *out);
+
+#endif
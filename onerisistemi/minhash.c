@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "minhash.h"
+#include "batch.h"
+
+#define SIGNATURE_BLOCK 64  //bir iş parçacığının bir seferde aldığı kullanıcı sayısı
+#define NOT_INDEXED -2      //entries[kullanıcı].next (ilk bant): hiç filmi yok, tablolarda değil
+
+// splitmix64'ün son karıştırma adımı
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint32_t movieHash(uint64_t seed, int movie) {
+    return (uint32_t)(mix64(seed ^ ((uint64_t)movie * 0x9E3779B97F4A7C15ULL)) >> 32);
+}
+
+static uint64_t bandKey(const uint32_t *signature, int band, int rows) {
+    uint64_t key = 0xcbf29ce484222325ULL;
+    for (int r = 0; r < rows; r++) {
+        key = (key ^ signature[band * rows + r]) * 0x100000001b3ULL;
+    }
+    return mix64(key);
+}
+
+static void computeSignature(const MinHashIndex *index, const RatingMatrix *matrix, int user) {
+    uint32_t *signature = index->signatures + (long)user * index->hashes;
+    for (int i = 0; i < index->hashes; i++) {
+        signature[i] = UINT32_MAX;
+    }
+    int length;
+    const int *movies = userRow(matrix, user, &length);
+    for (int j = 0; j < length; j++) {
+        for (int i = 0; i < index->hashes; i++) {
+            uint32_t h = movieHash(index->seeds[i], movies[j]);
+            if (h < signature[i]) {
+                signature[i] = h;
+            }
+        }
+    }
+}
+
+typedef struct SignatureState {
+    MinHashIndex *index;
+    const RatingMatrix *matrix;
+    int nextUser;  //sıradaki blok, atomik olarak artırılır
+} SignatureState;
+
+static void *signatureWorker(void *arg) {
+    SignatureState *state = (SignatureState *)arg;
+    int users = state->index->users;
+    for (;;) {
+        int first = __atomic_fetch_add(&state->nextUser, SIGNATURE_BLOCK, __ATOMIC_RELAXED);
+        if (first >= users) {
+            break;
+        }
+        int last = first + SIGNATURE_BLOCK < users ? first + SIGNATURE_BLOCK : users;
+        for (int user = first; user < last; user++) {
+            computeSignature(state->index, state->matrix, user);
+        }
+    }
+    return NULL;
+}
+
+static inline long bucketSlot(const MinHashIndex *index, int band, uint64_t key) {
+    return (long)band * (index->slotMask + 1) + (long)(key & index->slotMask);
+}
+
+static void insertBand(MinHashIndex *index, int user, int band) {
+    uint64_t key = bandKey(index->signatures + (long)user * index->hashes, band, index->rows);
+    MinHashEntry *entry = &index->entries[(long)band * index->users + user];
+    int *head = &index->heads[bucketSlot(index, band, key)];
+    entry->check = (uint32_t)(key >> 32);
+    entry->next = *head;
+    *head = user;
+}
+
+// Kullanıcıyı eski anahtarının (imza değişmeden önceki) kovasından çıkarır
+static void removeBand(MinHashIndex *index, int user, int band, uint64_t oldKey) {
+    MinHashEntry *entries = index->entries + (long)band * index->users;
+    int *link = &index->heads[bucketSlot(index, band, oldKey)];
+    while (*link != user) {
+        link = &entries[*link].next;
+    }
+    *link = entries[user].next;
+}
+
+MinHashIndex *buildMinHashIndex(const RatingMatrix *matrix, int bands, int rows, unsigned long long seed, int threads) {
+    MinHashIndex *index = (MinHashIndex *)malloc(sizeof(MinHashIndex));
+    int users = matrix->users;
+    index->users = users;
+    index->bands = bands;
+    index->rows = rows;
+    index->hashes = bands * rows;
+    index->seeds = (uint64_t *)malloc(index->hashes * sizeof(uint64_t));
+    for (int i = 0; i < index->hashes; i++) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        index->seeds[i] = mix64(seed);
+    }
+    index->signatures = (uint32_t *)malloc((long)users * index->hashes * sizeof(uint32_t));
+
+    SignatureState state = {index, matrix, 0};
+    if (threads <= 0) {
+        threads = defaultThreadCount();
+    }
+    pthread_t *workers = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, signatureWorker, &state);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    uint64_t slots = 1024;
+    while (slots < (uint64_t)users) {
+        slots *= 2;
+    }
+    index->slotMask = slots - 1;
+    index->heads = (int *)malloc((long)bands * slots * sizeof(int));
+    memset(index->heads, 0xff, (long)bands * slots * sizeof(int));  //-1
+    index->entries = (MinHashEntry *)malloc((long)bands * users * sizeof(MinHashEntry));
+    for (int user = 0; user < users; user++) {
+        if (matrix->rowEnds[user] == matrix->rowOffsets[user]) {
+            index->entries[user].next = NOT_INDEXED;
+            continue;
+        }
+        for (int band = 0; band < bands; band++) {
+            insertBand(index, user, band);
+        }
+    }
+    return index;
+}
+
+int parseMinHashShape(const char *text, int *bands, int *rows) {
+    char *end;
+    long b = strtol(text, &end, 10);
+    long r = MINHASH_ROWS;
+    if (*end == 'x') {
+        r = strtol(end + 1, &end, 10);
+    }
+    if (*end != '\0' || b < 1 || r < 1 || b * r > 1024) {
+        return -1;
+    }
+    *bands = (int)b;
+    *rows = (int)r;
+    return 0;
+}
+
+void freeMinHashIndex(MinHashIndex *index) {
+    if (index != NULL) {
+        free(index->seeds);
+        free(index->signatures);
+        free(index->entries);
+        free(index->heads);
+        free(index);
+    }
+}
+
+void addMinHashRating(MinHashIndex *index, int user, int movie) {
+    int indexed = index->entries[user].next != NOT_INDEXED;
+    uint32_t *signature = index->signatures + (long)user * index->hashes;
+    for (int band = 0; band < index->bands; band++) {
+        uint64_t oldKey = bandKey(signature, band, index->rows);
+        int changed = 0;
+        for (int r = 0; r < index->rows; r++) {
+            int i = band * index->rows + r;
+            uint32_t h = movieHash(index->seeds[i], movie);
+            if (h < signature[i]) {
+                signature[i] = h;
+                changed = 1;
+            }
+        }
+        if (changed || !indexed) {
+            if (indexed) {
+                removeBand(index, user, band, oldKey);
+            }
+            insertBand(index, user, band);
+        }
+    }
+}
+
+MinHashScratch *createMinHashScratch(int users) {
+    MinHashScratch *scratch = (MinHashScratch *)malloc(sizeof(MinHashScratch));
+    scratch->seen = (unsigned *)calloc(users, sizeof(unsigned));
+    scratch->stamp = 0;
+    scratch->common = (int *)calloc(users, sizeof(int));
+    scratch->touched = (int *)malloc(users * sizeof(int));
+    scratch->items = (ScoredItem *)malloc(users * sizeof(ScoredItem));
+    return scratch;
+}
+
+void freeMinHashScratch(MinHashScratch *scratch) {
+    free(scratch->seen);
+    free(scratch->common);
+    free(scratch->touched);
+    free(scratch->items);
+    free(scratch);
+}
+
+// İki kullanıcının Jaccard benzerliği; bit düzlemleri varsa satırlar AND'lenip sayılır, yoksa sıralı satırlar birleştirilir
+static double rowJaccard(const RatingMatrix *matrix, int a, int b) {
+    int lengthA, lengthB;
+    const int *rowA = userRow(matrix, a, &lengthA);
+    const int *rowB = userRow(matrix, b, &lengthB);
+    int common = 0;
+    if (matrix->wordsPerRow > 0) {
+        const uint64_t *bitsA = watchedRow(matrix, a);
+        const uint64_t *bitsB = watchedRow(matrix, b);
+        for (int w = 0; w < matrix->wordsPerRow; w++) {
+            common += __builtin_popcountll(bitsA[w] & bitsB[w]);
+        }
+    } else {
+        int i = 0, j = 0;
+        while (i < lengthA && j < lengthB) {
+            if (rowA[i] < rowB[j]) {
+                i++;
+            } else if (rowA[i] > rowB[j]) {
+                j++;
+            } else {
+                common++;
+                i++;
+                j++;
+            }
+        }
+    }
+    int total = lengthA + lengthB - common;
+    return total > 0 ? (double)common / total : 0.0;
+}
+
+static int finishSimilar(TopK *topk, int *users, double *scores) {
+    int count = topkFinish(topk);
+    for (int i = 0; i < count; i++) {
+        users[i] = topk->items[i].id;
+        if (scores != NULL) {
+            scores[i] = topk->items[i].score;
+        }
+    }
+    return count;
+}
+
+int findSimilarUsersLsh(const MinHashIndex *index, const RatingMatrix *matrix, int user, int k,
+                        MinHashScratch *scratch, int *users, double *scores, int *candidates) {
+    TopK topk;
+    topkInit(&topk, scratch->items, k);
+    int found = 0;
+    if (index->entries[user].next != NOT_INDEXED) {
+        if (++scratch->stamp == 0) {
+            memset(scratch->seen, 0, index->users * sizeof(unsigned));
+            scratch->stamp = 1;
+        }
+        unsigned stamp = scratch->stamp;
+        scratch->seen[user] = stamp;
+        const uint32_t *signature = index->signatures + (long)user * index->hashes;
+        for (int band = 0; band < index->bands; band++) {
+            const MinHashEntry *entries = index->entries + (long)band * index->users;
+            uint64_t key = bandKey(signature, band, index->rows);
+            uint32_t check = (uint32_t)(key >> 32);
+            for (int other = index->heads[bucketSlot(index, band, key)]; other >= 0; other = entries[other].next) {
+                if (entries[other].check == check && scratch->seen[other] != stamp) {
+                    scratch->seen[other] = stamp;
+                    topkPush(&topk, other, rowJaccard(matrix, user, other));
+                    found++;
+                }
+            }
+        }
+    }
+    if (candidates != NULL) {
+        *candidates = found;
+    }
+    return finishSimilar(&topk, users, scores);
+}
+
+int findSimilarUsersExact(const RatingMatrix *matrix, int user, int k, MinHashScratch *scratch, int *users, double *scores) {
+    int length;
+    const int *movies = userRow(matrix, user, &length);
+    int touchedCount = 0;
+    for (int i = 0; i < length; i++) {
+        int raterCount;
+        const int *raters = movieColumn(matrix, movies[i], &raterCount);
+        for (int j = 0; j < raterCount; j++) {
+            if (scratch->common[raters[j]]++ == 0) {
+                scratch->touched[touchedCount++] = raters[j];
+            }
+        }
+    }
+
+    TopK topk;
+    topkInit(&topk, scratch->items, k);
+    for (int t = 0; t < touchedCount; t++) {
+        int other = scratch->touched[t];
+        if (other != user) {
+            int common = scratch->common[other];
+            int otherLength = (int)(matrix->rowEnds[other] - matrix->rowOffsets[other]);
+            topkPush(&topk, other, (double)common / (length + otherLength - common));
+        }
+        scratch->common[other] = 0;
+    }
+    return finishSimilar(&topk, users, scores);
+}
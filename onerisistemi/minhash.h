@@ -0,0 +1,73 @@
+#ifndef MINHASH_H
+#define MINHASH_H
+
+#include <stdint.h>
+
+#include "bitmatrix.h"
+#include "topk.h"
+
+// Yaklaşık en benzer kullanıcı araması (MinHash + LSH).
+// Her kullanıcının izlediği film kümesi için bands * rows uzunlukta MinHash imzası tutulur:
+// imza[i] = izlenen filmler arasında h_i(film)'in en küçüğü. İki kullanıcının imzalarının bir konumda eşit
+// olma olasılığı film kümelerinin Jaccard benzerliğine (ortak / birleşim) eşittir.
+// İmza rows'luk bantlara bölünür; her bant için bir karma tablosu vardır ve kullanıcı her bantta bant
+// değerlerinin düştüğü kovadadır. Sorguda sadece en az bir bantta aynı kovaya düşen kullanıcılar aday olur,
+// adaylar gerçek Jaccard ile (sıralı satırların kesişimi) sıralanır.
+// Jaccard'ı s olan bir kullanıcının aday olma olasılığı 1 - (1 - s^rows)^bands'tir: bant sayısı arttıkça
+// isabet (recall) artar ama aday sayısı da artar; satır sayısı arttıkça tersi.
+//
+// Kullanıcı her bantta tam bir kovada durduğu için kovalar kullanıcılar üzerinden bağlı liste (next) olarak
+// tutulur, ek bellek bant başına kullanıcı başına 8 bayttır. Anahtarın alt bitleri kovayı seçer, üst 32 biti
+// kovadaki başka anahtarları ayırmak için saklanır (aynı satırda, tek önbellek erişimiyle okunur).
+// Yeni bir puan imzayı sadece küçültebilir; addMinHashRating değişen bantlarda kullanıcıyı yeni kovaya taşır.
+// Puan silme desteklenmez (canlı modda da silme yoktur).
+
+#define MINHASH_ROWS 2
+#define MINHASH_SEED 42   //aynı veriyle hep aynı dizin kurulsun diye sabit
+
+typedef struct MinHashEntry {
+    uint32_t check;       //bant anahtarının üst 32 biti
+    int next;             //aynı kovadaki sıradaki kullanıcı (-1 son)
+} MinHashEntry;
+
+typedef struct MinHashIndex {
+    int users;
+    int bands;
+    int rows;
+    int hashes;           //bands * rows
+    uint64_t *seeds;      //hashes, her karma fonksiyonunun tohumu
+    uint32_t *signatures; //users * hashes
+    MinHashEntry *entries; //bands * users
+    int *heads;           //bands * slotCount, kovanın ilk kullanıcısı (-1 boş)
+    uint64_t slotMask;    //slotCount - 1
+} MinHashIndex;
+
+// Sorgu başına çalışma alanı (iş parçacığı başına bir tane)
+typedef struct MinHashScratch {
+    unsigned *seen;       //users, aday işareti (damga)
+    unsigned stamp;
+    int *common;          //users, kesin aramada ortak film sayıları
+    int *touched;         //users
+    ScoredItem *items;    //users
+} MinHashScratch;
+
+// Kullanıcı ve film 0 tabanlı. threads 0 ise çekirdek sayısı kadar; imzalar paralel hesaplanır.
+MinHashIndex *buildMinHashIndex(const RatingMatrix *matrix, int bands, int rows, unsigned long long seed, int threads);
+void freeMinHashIndex(MinHashIndex *index);
+// "-L bant" ya da "-L bantxsatir" değerini okur (satır verilmezse MINHASH_ROWS); geçersizse -1 döner
+int parseMinHashShape(const char *text, int *bands, int *rows);
+// Kullanıcı yeni bir film izleyince (puanı değişince değil) çağrılır
+void addMinHashRating(MinHashIndex *index, int user, int movie);
+
+MinHashScratch *createMinHashScratch(int users);
+void freeMinHashScratch(MinHashScratch *scratch);
+
+// En benzer k kullanıcı (kullanıcının kendisi hariç), Jaccard'a göre azalan, eşitlikte küçük id önce.
+// users dizisine 0 tabanlı kullanıcılar, scores dizisine Jaccard yazılır (NULL olabilir), bulunan sayı döner.
+// Yaklaşık arama: sadece LSH adayları arasından; candidates verilirse aday sayısı yazılır.
+int findSimilarUsersLsh(const MinHashIndex *index, const RatingMatrix *matrix, int user, int k,
+                        MinHashScratch *scratch, int *users, double *scores, int *candidates);
+// Kesin arama: ters indeksle tüm kullanıcılar (isabet ölçümü için)
+int findSimilarUsersExact(const RatingMatrix *matrix, int user, int k, MinHashScratch *scratch, int *users, double *scores);
+
+#endif
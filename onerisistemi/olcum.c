@@ -0,0 +1,417 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "recommend1.h"
+#include "recommend2.h"
+#include "metrics.h"
+
+// Tüm öneri fonksiyonlarını her kullanıcı için sabit tohumla çalıştırıp süreleri JSON olarak yazar.
+// Kullanım: ./olcum [-f puanlar] [-i filmler] [-S veri.snap] [-k oneri] [-w adim] [-s tohum] [-L bant[xsatir]] [-M model.mf] [-T gun] [-o sonuc.json]
+// Her fonksiyon için çağrı başına gecikme yüzdelikleri (p50/p90/p99/max), saniyedeki çağrı sayısı ve
+// sonuçların sağlama toplamı verilir; sağlama toplamı değişirse fonksiyonun çıktısı da değişmiş demektir.
+// Ölçümler tek iş parçacığında yapılır, böylece çalıştırmalar arası karşılaştırılabilir.
+// -DONERI_METRICS ile derlenirse evre süreleri ve sayaçlar da "metrics" alanına yazılır.
+// -L ile MinHash/LSH dizini kurulur; en benzer k kullanıcının yaklaşık ve kesin (Jaccard) aramaları da ölçülür,
+// "lsh" alanına kurma süresi, ortalama aday sayısı ve kesin cevaba göre isabet (recall@k ve recall@1) yazılır.
+// İsabette eşitlikler sayılır: yaklaşık sonuçtaki benzerliği kesin k. sonuçtan düşük olmayan her kullanıcı isabettir.
+// -M ile egit'in yazdığı model açılır, kullanıcı başına tüm filmleri puanlayan recommendFactors da ölçülür.
+// -T ile trend dizini kurulur; "şimdi"ye göre çürümüş popülerlik ve son TREND_WINDOW_DAYS günün puan sayısıyla
+// (geçmiş/pencere sorgusu yolu) recommendTrending ölçülür, "trend" alanına kurma süresi yazılır.
+// Bit düzlemleri kuruluysa sameRatingOneVsAll (kullanıcı başına) ve cowatchBlock (tüm kullanıcı çiftleri,
+// COWATCH_BLOCK_USERS'lık bloklarla) da ölçülür; sonuçları sütunları gezen skaler yolla karşılaştırılır,
+// "bit_kernels" alanına farklı çıkan satır sayısı yazılır (0 değilse program 1 ile biter).
+// "store" alanına puan deposunun seyrek dizilerinin ve bit düzlemlerinin boyu ile puan başına toplam bayt yazılır.
+
+#define TREND_WINDOW_DAYS 30
+#define COWATCH_BLOCK_USERS 64
+
+typedef struct Measurement {
+    const char *name;
+    long *nanos;          //çağrı başına süre
+    int calls;
+    unsigned long long checksum;
+} Measurement;
+
+static long nowNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// Sonuç listesini sağlama toplamına katar (sıra önemli)
+static unsigned long long mixResult(unsigned long long checksum, const int *movies, int count) {
+    checksum ^= (unsigned long long)count + 0x9E3779B97F4A7C15ULL + (checksum << 6) + (checksum >> 2);
+    for (int i = 0; i < count; i++) {
+        checksum ^= (unsigned long long)movies[i] + 0x9E3779B97F4A7C15ULL + (checksum << 6) + (checksum >> 2);
+    }
+    return checksum;
+}
+
+static int compareLong(const void *a, const void *b) {
+    long x = *(const long *)a;
+    long y = *(const long *)b;
+    return (x > y) - (x < y);
+}
+
+// Sıralı dizide p yüzdeliği (en yakın sıra yöntemi)
+static long percentile(const long *sorted, int count, double p) {
+    int index = (int)(p / 100.0 * count + 0.999999) - 1;
+    if (index < 0) {
+        index = 0;
+    }
+    if (index >= count) {
+        index = count - 1;
+    }
+    return sorted[index];
+}
+
+static void writeMeasurement(FILE *out, Measurement *m, int last) {
+    long total = 0;
+    for (int i = 0; i < m->calls; i++) {
+        total += m->nanos[i];
+    }
+    qsort(m->nanos, m->calls, sizeof(long), compareLong);
+    fprintf(out, "    {\"name\": \"%s\", \"calls\": %d, \"total_ms\": %.3f, \"throughput_per_s\": %.1f, "
+                 "\"p50_us\": %.2f, \"p90_us\": %.2f, \"p99_us\": %.2f, \"max_us\": %.2f, \"checksum\": \"%016llx\"}%s\n",
+            m->name, m->calls, total / 1e6, total > 0 ? m->calls / (total / 1e9) : 0.0,
+            percentile(m->nanos, m->calls, 50) / 1e3, percentile(m->nanos, m->calls, 90) / 1e3,
+            percentile(m->nanos, m->calls, 99) / 1e3, m->nanos[m->calls - 1] / 1e3, m->checksum, last ? "" : ",");
+}
+
+static unsigned long long userSeed(unsigned long long seed, int user) {
+    return seed ^ (0x9E3779B97F4A7C15ULL * (unsigned long long)user);
+}
+
+// Bit çekirdeklerinin karşılaştırıldığı skaler yol: kullanıcının satırındaki her filmin sütunu gezilir.
+// counts[v] = user ile v'nin ortak film sayısı (sameRating 1 ise aynı puanı verdikleri film sayısı)
+static void columnCounts(const RatingMatrix *matrix, int user, int sameRating, int *counts) {
+    memset(counts, 0, matrix->users * sizeof(int));
+    for (long i = matrix->rowOffsets[user]; i < matrix->rowEnds[user]; i++) {
+        int movie = matrix->rowMovies[i];
+        for (long j = matrix->colOffsets[movie]; j < matrix->colEnds[movie]; j++) {
+            if (!sameRating || matrix->colRatings[j] == matrix->rowRatings[i]) {
+                counts[matrix->colUsers[j]]++;
+            }
+        }
+    }
+}
+
+// firstA'dan başlayan countA kullanıcının tüm kullanıcılarla ortak film sayıları, B tarafı bloklara bölünerek
+// cowatchBlock ile hesaplanır: rows[i * users + v]
+static void cowatchRows(const RatingMatrix *matrix, int firstA, int countA, int *block, int *rows) {
+    int users = matrix->users;
+    for (int firstB = 0; firstB < users; firstB += COWATCH_BLOCK_USERS) {
+        int countB = users - firstB < COWATCH_BLOCK_USERS ? users - firstB : COWATCH_BLOCK_USERS;
+        cowatchBlock(matrix, firstA, countA, firstB, countB, block);
+        for (int i = 0; i < countA; i++) {
+            memcpy(rows + (long)i * users + firstB, block + i * countB, countB * sizeof(int));
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *snapshotFile = NULL;
+    const char *ratingsFile = "u.data";
+    const char *itemsFile = "u.item";
+    const char *outputFile = NULL;
+    int rec = 10;
+    long steps = 20000;
+    unsigned long long seed = 42;
+    int lshBands = 0;
+    int lshRows = MINHASH_ROWS;
+    const char *modelFile = NULL;
+    double halfLifeDays = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+            snapshotFile = argv[++i];
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            ratingsFile = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            itemsFile = argv[++i];
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            rec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            steps = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) {
+            if (parseMinHashShape(argv[++i], &lshBands, &lshRows) != 0) {
+                printf("Gecersiz LSH boyutu: %s (ornek: 16 ya da 16x4)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+            modelFile = argv[++i];
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            halfLifeDays = atof(argv[++i]);
+            if (halfLifeDays <= 0) {
+                printf("Gecersiz yari omur: %s (gun)\n", argv[i]);
+                return 1;
+            }
+        } else {
+            printf("Kullanim: %s [-f puanlar] [-i filmler] [-S veri.snap] [-k oneri] [-w adim] [-s tohum] [-L bant[xsatir]] [-M model.mf] [-T gun] [-o sonuc.json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rec < 1) {
+        printf("Gecersiz oneri sayisi.\n");
+        return 1;
+    }
+
+    long loadStart = nowNanos();
+    if (snapshotFile != NULL) {
+        const Snapshot *opened = loadFromSnapshot(snapshotFile, ratingsFile, itemsFile);
+        share_rating_data(ratingMatrix);
+        load_genres_from_snapshot(opened);
+    } else {
+        loadRatingStore(ratingsFile);
+        share_rating_data(ratingMatrix);
+        build_movie_genres(itemsFile);
+    }
+    long loadNanos = nowNanos() - loadStart;
+    long lshBuildNanos = 0;
+    if (lshBands > 0) {
+        long start = nowNanos();
+        userIndex = buildMinHashIndex(ratingMatrix, lshBands, lshRows, MINHASH_SEED, 0);
+        lshBuildNanos = nowNanos() - start;
+    }
+    if (modelFile != NULL && (factorModel = loadFactorModel(modelFile, ratingMatrix)) == NULL) {
+        return 1;
+    }
+    long trendBuildNanos = 0;
+    if (halfLifeDays > 0) {
+        long start = nowNanos();
+        trendIndex = buildTrendIndex(ratingMatrix, halfLifeDays);
+        trendBuildNanos = nowNanos() - start;
+    }
+    if (rec > numMovies) {
+        rec = numMovies;
+    }
+
+    enum {
+        M_RANDOM, M_HIGH_DEGREE, M_SIMILAR_USER, M_FROM_SIMILAR, M_DIJKSTRA_SCAN, M_DIJKSTRA_HEAP,
+        M_DIJKSTRA_BUCKET, M_NEAREST, M_GENRE, M_WALK, M_ITEM,
+        M_SAME_RATING, M_COWATCH_BLOCK, M_LSH, M_EXACT, M_MF,
+        M_TRENDING, M_TRENDING_WINDOW, M_COUNT
+    };
+    Measurement measurements[M_COUNT] = {
+        {.name = "recommendRandom"}, {.name = "recommendHighDegree"}, {.name = "findMostSimilarUser"},
+        {.name = "recommendFromSimilarUser"}, {.name = "dijkstra_scan"}, {.name = "dijkstra_heap"},
+        {.name = "dijkstra_bucket"}, {.name = "recommendNearestMovies"}, {.name = "recommend_movies"},
+        {.name = "random_walk_recommendation"}, {.name = "recommendSimilarItems"}, {.name = "sameRatingOneVsAll"},
+        {.name = "cowatchBlock"}, {.name = "findSimilarUsersLsh"}, {.name = "findSimilarUsersExact"},
+        {.name = "recommendFactors"}, {.name = "recommendTrending"}, {.name = "recommendTrending_window"}
+    };
+    // LSH ölçümleri sadece -L ile, model ölçümü sadece -M ile, trend ölçümleri sadece -T ile, bit çekirdekleri
+    // sadece düzlemler kuruluysa yapılır; ölçülmeyenlerin nanos'u NULL kalır
+    int bitPlanes = ratingMatrix->wordsPerRow > 0;
+    for (int m = 0; m < M_COUNT; m++) {
+        int skipped = (userIndex == NULL && (m == M_LSH || m == M_EXACT)) || (factorModel == NULL && m == M_MF) ||
+                      (trendIndex == NULL && (m == M_TRENDING || m == M_TRENDING_WINDOW)) ||
+                      (!bitPlanes && (m == M_SAME_RATING || m == M_COWATCH_BLOCK));
+        measurements[m].nanos = skipped ? NULL : (long *)malloc(numUsers * sizeof(long));
+    }
+
+    int *movies = (int *)malloc(rec * sizeof(int));
+    ScoredItem *best = (ScoredItem *)malloc(rec * sizeof(ScoredItem));
+    TrendQuery window = {0, 0, 0};
+    if (trendIndex != NULL) {
+        unsigned int width = TREND_WINDOW_DAYS * TREND_DAY_SECONDS;
+        window.to = trendIndex->lastTime;
+        window.from = window.to > width ? window.to - width : 0;
+    }
+    double *ratings = (double *)malloc(rec * sizeof(double));
+    unsigned *visits = (unsigned *)malloc((numUsers + numMovies) * sizeof(unsigned));
+    DijkstraScratch *scratch = createDijkstraScratch(ratingMatrix);
+    ItemScratch *items = createItemScratch(numMovies);
+    MinHashScratch *similar = createMinHashScratch(numUsers);
+    FactorScratch *factors = createFactorScratch(numMovies);
+    int *similarUsers = (int *)malloc(2 * rec * sizeof(int));
+    double *similarScores = (double *)malloc(2 * rec * sizeof(double));
+    double recallSum = 0, recallTopSum = 0;
+    long candidateSum = 0;
+    int recallUsers = 0;
+    DijkstraMode modes[3] = {DIJKSTRA_SCAN, DIJKSTRA_HEAP, DIJKSTRA_BUCKET};
+    int *kernelCounts = (int *)malloc((long)COWATCH_BLOCK_USERS * numUsers * sizeof(int));
+    int *expectedCounts = (int *)malloc(numUsers * sizeof(int));
+    int *block = (int *)malloc(COWATCH_BLOCK_USERS * COWATCH_BLOCK_USERS * sizeof(int));
+    long kernelMismatches = 0;
+
+// Bir çağrıyı süresini ölçerek çalıştırır, sonucu sağlama toplamına katar
+#define MEASURE(index, call, resultMovies, resultCount)                  \
+    do {                                                                 \
+        Measurement *m_ = &measurements[index];                          \
+        long start_ = nowNanos();                                        \
+        call;                                                            \
+        m_->nanos[m_->calls++] = nowNanos() - start_;                    \
+        m_->checksum = mixResult(m_->checksum, resultMovies, resultCount); \
+    } while (0)
+
+    for (int user = 1; user <= numUsers; user++) {
+        Rng rng;
+        int count = 0;
+
+        rngSeed(&rng, userSeed(seed, user));
+        MEASURE(M_RANDOM, count = recommendRandom(user, rec, &rng, movies), movies, count);
+        MEASURE(M_HIGH_DEGREE, count = recommendHighDegree(user, rec, best, movies), movies, count);
+
+        int similarUser = 0;
+        MEASURE(M_SIMILAR_USER, similarUser = findMostSimilarUser(user), &similarUser, 1);
+        MEASURE(M_FROM_SIMILAR, count = similarUser != -1 ? recommendFromSimilarUser(user, similarUser, rec, movies) : 0,
+                movies, count);
+
+        DijkstraMode savedMode = dijkstraMode;
+        for (int i = 0; i < 3; i++) {
+            dijkstraMode = modes[i];
+            MEASURE(M_DIJKSTRA_SCAN + i, dijkstra(ratingMatrix, user - 1, scratch->distances, scratch),
+                    &scratch->visitedCount, 1);
+        }
+        dijkstraMode = savedMode;
+
+        MEASURE(M_NEAREST, count = recommendNearestMovies(user, rec, scratch, movies), movies, count);
+
+        int favoriteGenre, maxCount;
+        find_favorite_genre(user_genre_count[user - 1], &favoriteGenre, &maxCount);
+        MEASURE(M_GENRE, count = favoriteGenre != -1 ? recommend_movies(user - 1, favoriteGenre, rec, movies, ratings) : 0,
+                movies, count);
+
+        WalkConfig walk = {steps, 0.15, 1, userSeed(seed, user)};
+        MEASURE(M_WALK, count = random_walk_recommendation(user - 1, &walk, rec, visits, best, movies), movies, count);
+
+        MEASURE(M_ITEM, count = recommendSimilarItems(itemNeighbors, ratingMatrix, user, rec, items, movies), movies, count);
+
+        if (bitPlanes) {
+            MEASURE(M_SAME_RATING, sameRatingOneVsAll(ratingMatrix, user - 1, kernelCounts), kernelCounts, numUsers);
+            columnCounts(ratingMatrix, user - 1, 1, expectedCounts);
+            kernelMismatches += memcmp(kernelCounts, expectedCounts, numUsers * sizeof(int)) != 0;
+        }
+
+        if (userIndex != NULL) {
+            int *approxUsers = similarUsers + rec;
+            double *approxScores = similarScores + rec;
+            int candidates = 0, approxCount = 0, exactCount = 0;
+            MEASURE(M_LSH, approxCount = findSimilarUsersLsh(userIndex, ratingMatrix, user - 1, rec, similar, approxUsers,
+                                                             approxScores, &candidates), approxUsers, approxCount);
+            MEASURE(M_EXACT, exactCount = findSimilarUsersExact(ratingMatrix, user - 1, rec, similar, similarUsers,
+                                                                similarScores), similarUsers, exactCount);
+            if (exactCount > 0) {
+                int hits = 0;
+                for (int i = 0; i < approxCount && hits < exactCount; i++) {
+                    hits += approxScores[i] >= similarScores[exactCount - 1];
+                }
+                recallSum += (double)hits / exactCount;
+                recallTopSum += approxCount > 0 && approxScores[0] >= similarScores[0];
+                recallUsers++;
+            }
+            candidateSum += candidates;
+        }
+
+        if (factorModel != NULL) {
+            MEASURE(M_MF, count = recommendFactors(factorModel, ratingMatrix, user, rec, factors, movies), movies, count);
+        }
+
+        if (trendIndex != NULL) {
+            MEASURE(M_TRENDING, count = recommendTrending(trendIndex, ratingMatrix, user, rec, NULL, NULL, movies),
+                    movies, count);
+            MEASURE(M_TRENDING_WINDOW,
+                    count = recommendTrending(trendIndex, ratingMatrix, user, rec, &window, best, movies),
+                    movies, count);
+        }
+    }
+
+    // Tüm kullanıcı çiftleri: her çağrı COWATCH_BLOCK_USERS satırı tüm kullanıcılarla karşılaştırır
+    for (int first = 0; bitPlanes && first < numUsers; first += COWATCH_BLOCK_USERS) {
+        int count = numUsers - first < COWATCH_BLOCK_USERS ? numUsers - first : COWATCH_BLOCK_USERS;
+        MEASURE(M_COWATCH_BLOCK, cowatchRows(ratingMatrix, first, count, block, kernelCounts), kernelCounts,
+                count * numUsers);
+        for (int i = 0; i < count; i++) {
+            columnCounts(ratingMatrix, first + i, 0, expectedCounts);
+            kernelMismatches += memcmp(kernelCounts + (long)i * numUsers, expectedCounts, numUsers * sizeof(int)) != 0;
+        }
+    }
+#undef MEASURE
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    FILE *out = stdout;
+    if (outputFile != NULL) {
+        out = fopen(outputFile, "w");
+        if (!out) {
+            printf("Cikti dosyasi acilamadi: %s\n", outputFile);
+            return 1;
+        }
+    }
+    fprintf(out, "{\n");
+    fprintf(out, "  \"source\": \"%s\",\n", snapshotFile ? snapshotFile : ratingsFile);
+    fprintf(out, "  \"users\": %d,\n  \"movies\": %d,\n  \"k\": %d,\n  \"walk_steps\": %ld,\n  \"seed\": %llu,\n",
+            numUsers, numMovies, rec, steps, seed);
+    fprintf(out, "  \"load_ms\": %.3f,\n", loadNanos / 1e6);
+    fprintf(out, "  \"peak_rss_kb\": %ld,\n", usage.ru_maxrss);
+    if (METRICS_ENABLED) {
+        MetricsSnapshot metrics;
+        metricsCollect(&metrics);
+        fprintf(out, "  \"metrics\": ");
+        metricsWriteJson(out, &metrics);
+        fprintf(out, ",\n");
+    }
+    if (userIndex != NULL) {
+        fprintf(out, "  \"lsh\": {\"bands\": %d, \"rows\": %d, \"build_ms\": %.3f, \"avg_candidates\": %.1f, "
+                     "\"recall_at_k\": %.4f, \"recall_at_1\": %.4f},\n",
+                lshBands, lshRows, lshBuildNanos / 1e6, (double)candidateSum / numUsers,
+                recallUsers > 0 ? recallSum / recallUsers : 0.0, recallUsers > 0 ? recallTopSum / recallUsers : 0.0);
+    }
+    if (trendIndex != NULL) {
+        fprintf(out, "  \"trend\": {\"half_life_days\": %.2f, \"window_days\": %d, \"build_ms\": %.3f},\n",
+                halfLifeDays, TREND_WINDOW_DAYS, trendBuildNanos / 1e6);
+    }
+    long sparseBytes, planeBytes;
+    ratingMatrixBytes(ratingMatrix, &sparseBytes, &planeBytes);
+    fprintf(out, "  \"store\": {\"ratings\": %ld, \"sparse_bytes\": %ld, \"plane_bytes\": %ld, \"bytes_per_rating\": %.2f},\n",
+            ratingMatrix->nonZeros, sparseBytes, planeBytes,
+            ratingMatrix->nonZeros > 0 ? (double)(sparseBytes + planeBytes) / ratingMatrix->nonZeros : 0.0);
+    if (bitPlanes) {
+        fprintf(out, "  \"bit_kernels\": {\"avx2\": %d, \"mismatches\": %ld},\n", bitKernelUsesAvx2(), kernelMismatches);
+    }
+    fprintf(out, "  \"benchmarks\": [\n");
+    int lastMeasured = M_COUNT - 1;
+    while (measurements[lastMeasured].nanos == NULL) {
+        lastMeasured--;
+    }
+    for (int m = 0; m <= lastMeasured; m++) {
+        if (measurements[m].nanos != NULL) {
+            writeMeasurement(out, &measurements[m], m == lastMeasured);
+            free(measurements[m].nanos);
+        }
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    freeItemScratch(items);
+    freeMinHashScratch(similar);
+    freeFactorScratch(factors);
+    free(similarUsers);
+    free(similarScores);
+    freeDijkstraScratch(scratch);
+    free(visits);
+    free(ratings);
+    free(best);
+    free(movies);
+    free(kernelCounts);
+    free(expectedCounts);
+    free(block);
+    free_bipartite_matrix();
+    freeRatingStore();
+    if (kernelMismatches > 0) {
+        fprintf(stderr, "Bit cekirdekleri skaler yoldan farkli: %ld satir\n", kernelMismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -1,445 +1,313 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>  
-#include <float.h>
 #include <time.h>
 #include <string.h>
 
-#define USERS 943
-#define MOVIES 1683
-#define MAX_VERTICES (USERS + MOVIES)
-
-// Kullanıcı ve film ilişkisi için yapı
-typedef struct Node {
-    int movieId;
-    int rating;
-    struct Node *next;
-} Node;
-
-// Kenarı temsil eder
-typedef struct Edge {
-    int dest;
-    float weight;
-    struct Edge *next;
-} Edge;
-
-// Grafik yapısı
-typedef struct Graph {
-    int vertices;  //düğüm
-    Edge **adjList; //Her düğümün bağlantılarını (komşularını) bir liste şeklinde saklar.
-} Graph;
-
-// Global değişkenler
-Node *userMovies[USERS + 1] = {NULL}; //userMovies[1]: Kullanıcı 1'in izlediği filmleri gösteren linked listinn başlangıcını iişaret ediyor
-int movieDegree[MOVIES + 1] = {0};  // her filmin derecesi (kaç kişi izlemiş)
-
-// Fonksiyon Bildirimleri
-void addMovieToUser(int user, int movie, int rating);
-void createRecommendationsFile(const char *inputFile, const char *outputFile);
-void buildGraphFromFile(const char *fileName, Graph *graph, bool *watchedMovies, int userId);
-Graph *createGraph(int vertices);
-void addEdge(Graph *graph, int src, int dest, float weight);
-void dijkstra(Graph *graph, int src, float *distances);
-void recommendNearestMovies(Graph *graph, int userId, bool *watchedMovies, int rec);
-void recommendRandom(int user, int rec);
-void recommendHighDegree(int user, int rec);
-int findMostSimilarUser(int targetUser);
-void recommendFromSimilarUser(int targetUser, int similarUser, int rec);
-void recommendTopNFromNearest(float *movieDistances, int *movieIds, int count, int n);
-void freeGraph();
-
-// Kullanıcıya bir film eklemek için
-void addMovieToUser(int user, int movie, int rating) {
-    Node *newNode = (Node *)malloc(sizeof(Node));
-    newNode->movieId = movie;
-    newNode->rating = rating;
-    newNode->next = userMovies[user];
-    userMovies[user] = newNode;
-    movieDegree[movie]++;
-}//Film userMovies arrayine eklenir ve movieDegree artırılır.
-
-
-// Yeni bir grafik oluşturma
-Graph *createGraph(int vertices) {
-    Graph *graph = (Graph *)malloc(sizeof(Graph));
-    graph->vertices = vertices;
-    graph->adjList = (Edge **)malloc(vertices * sizeof(Edge *));
-    for (int i = 0; i < vertices; i++) {
-        graph->adjList[i] = NULL;
-    }
-    return graph;
-}
-
-
+#include "batch.h"
+#include "recommend1.h"
+#include "metrics.h"
 
-//adjList bir arraydir ve 
-//bu arrayin her bir elemanı bir linked list'in başlangıcını işaret eder
-// Kenar ekle
-void addEdge(Graph *graph, int start, int dest, float weight) {
-    Edge *edge = (Edge *)malloc(sizeof(Edge));
-    edge->dest = dest;
-    edge->weight = weight;
-    edge->next = graph->adjList[start];
-    graph->adjList[start] = edge;
+// Toplu modda tüm iş parçacıklarının ortak (sadece okunan) verisi
+typedef struct BatchContext {
+    int rec;
+    unsigned long long seed;
+} BatchContext;
+
+// Her iş parçacığının kendi çalışma alanı
+typedef struct BatchWorker {
+    DijkstraScratch *scratch;
+    ItemScratch *items;
+    MinHashScratch *similar; //sadece -L ile
+    FactorScratch *factors;  //sadece -M ile
+    ScoredItem *best;        //rec elemanlı, en iyi k seçimi için
+    int *movies;
+} BatchWorker;
+
+static void *batchThreadInit(void *ctx) {
+    BatchContext *context = (BatchContext *)ctx;
+    BatchWorker *worker = (BatchWorker *)malloc(sizeof(BatchWorker));
+    worker->scratch = createDijkstraScratch(ratingMatrix);
+    worker->items = createItemScratch(numMovies);
+    worker->similar = userIndex != NULL ? createMinHashScratch(numUsers) : NULL;
+    worker->factors = factorModel != NULL ? createFactorScratch(numMovies) : NULL;
+    worker->best = (ScoredItem *)malloc(context->rec * sizeof(ScoredItem));
+    worker->movies = (int *)malloc(context->rec * sizeof(int));
+    return worker;
 }
 
-// u.data dosyasını okuyarak interactions.txt oluşturuyor
-void createRecommendationsFile(const char *inputFile, const char *outputFile) {
-    FILE *inFile = fopen(inputFile, "r"); //okuma modu
-    FILE *outFile = fopen(outputFile, "w"); //yama mosu
-
-    if (!inFile || !outFile) {
-        printf("Dosyalari acarken hata olustu.\n");
-        exit(1);
+static void batchThreadFree(void *threadState) {
+    BatchWorker *worker = (BatchWorker *)threadState;
+    freeDijkstraScratch(worker->scratch);
+    freeItemScratch(worker->items);
+    if (worker->similar != NULL) {
+        freeMinHashScratch(worker->similar);
     }
-
-    int userId, itemId, rating, timestamp;
-    while (fscanf(inFile, "%d %d %d %d", &userId, &itemId, &rating, &timestamp) != EOF) {
-        fprintf(outFile, "%d %d %d\n", userId, itemId, rating);
+    if (worker->factors != NULL) {
+        freeFactorScratch(worker->factors);
     }
-
-    fclose(inFile);
-    fclose(outFile);
+    free(worker->best);
+    free(worker->movies);
+    free(worker);
 }
 
-// Grafiği dosyadan oluştur
-void buildGraphFromFile(const char *fileName, Graph *graph, bool *watchedMovies, int userId) {
-    FILE *file = fopen(fileName, "r");
-    if (!file) {
-        printf("Dosya acilamadi: %s\n", fileName);
-        exit(1);
-    }
-
-    int userIdFromFile, itemId, rating;
-    while (fscanf(file, "%d %d %d", &userIdFromFile, &itemId, &rating) != EOF) {
-        addMovieToUser(userIdFromFile, itemId, rating);
+// Bir kullanıcı için tüm öneri yöntemlerini çalıştırır
+// Rastgele sayı üreteci kullanıcıya göre tohumlanır, böylece sonuç iş parçacığı sırasından bağımsızdır
+static void batchProcessUser(int user, void *ctx, void *threadState, BatchBuffer *out) {
+    BatchContext *context = (BatchContext *)ctx;
+    BatchWorker *worker = (BatchWorker *)threadState;
+    Rng rng;
+    rngSeed(&rng, context->seed ^ (0x9E3779B97F4A7C15ULL * (unsigned long long)user));
 
-        int userNode = userIdFromFile - 1;
-        int movieNode = USERS + (itemId - 1);
-        float weight = 1.0 / rating; // Ağırlık hesaplama 1/rating yaptım çünkü 4. öneride en yakına gitmesini istiyorum yani en yüksek puanlıya
-        addEdge(graph, userNode, movieNode, weight);
-        addEdge(graph, movieNode, userNode, weight);
+    int count = recommendRandom(user, context->rec, &rng, worker->movies);
+    batchWriteList(out, user, "random", worker->movies, count);
 
-        if (userIdFromFile == userId) {
-            watchedMovies[itemId - 1] = true;
-        }
-    }
+    count = recommendHighDegree(user, context->rec, worker->best, worker->movies);
+    batchWriteList(out, user, "high_degree", worker->movies, count);
 
-    fclose(file);
-}
+    int similarUser = worker->similar != NULL ? findSimilarUserApprox(user, worker->similar) : findMostSimilarUser(user);
+    count = similarUser != -1 ? recommendFromSimilarUser(user, similarUser, context->rec, worker->movies) : 0;
+    batchWriteList(out, user, "similar_user", worker->movies, count);
 
-// Dijkstra algoritması
-void dijkstra(Graph *graph, int src, float *distances) {
-    int V = graph->vertices;
-    bool *visited = (bool *)calloc(V, sizeof(bool));  //düğümün ziyaret edilip edilmediğini tutuyor
-    int visitedCount = 0; 
+    count = recommendNearestMovies(user, context->rec, worker->scratch, worker->movies);
+    batchWriteList(out, user, "nearest", worker->movies, count);
 
-    for (int i = 0; i < V; i++) {
-        distances[i] = FLT_MAX;  //en başta hepsi kaynak düğüme sonsuz uzaklıkta
-    }
-    distances[src] = 0.0; //kaynak düğüm 
-
-    for (int count = 0; count < V; count++) {
-        float minDist = FLT_MAX; 
-        int minIndex = -1;
-        for (int v = 0; v < V; v++) {
-            if (!visited[v] && distances[v] < minDist) {
-                minDist = distances[v];
-                minIndex = v;
-            }
-        }
-
-        if (minIndex == -1) {
-            break;
-        }
-
-        visited[minIndex] = true;  // kaynağa en yakın olan düğüm bulunur.
-        visitedCount++;
-
-        Edge *edge = graph->adjList[minIndex]; 
-        while (edge != NULL) {  //Seçilen düğümün komşuları dolaşılır.
-            int dest = edge->dest;
-            float weight = edge->weight;
-            if (!visited[dest] && distances[minIndex] + weight < distances[dest]) {
-                distances[dest] = distances[minIndex] + weight;
-            }  //kaynak düğümden diğer düğümlere olan mesafeler distances içinde depolanır
-            edge = edge->next;
-        }
-    } //kaynak düğümden (bizim öneri istediğimiz kullanıcı) ulaşılabilecek her yere ulaşıp onların mesafesini bulana kadar devam eder
-    printf("Ziyaret edilen düğüm sayısı: %d\n", visitedCount);
-
-    free(visited);
-}
-
-// En yakın filmleri bul ve belirli bir sayı öner
-void recommendNearestMovies(Graph *graph, int userId, bool *watchedMovies, int rec) {  //Kullanıcının izlediği filmleri tutan dizi.
-    float *distances = (float *)malloc(graph->vertices * sizeof(float));
-    int userNode = userId - 1;
-
-    dijkstra(graph, userNode, distances);  //Dijkstra algoritması çağrılarak kullanıcıdan tüm düğümlere olan mesafeler hesaplanır.
-
-
-    float movieDistances[MOVIES];
-    int movieIds[MOVIES];
-    int movieCount = 0;
-
-    for (int i = USERS; i < USERS + MOVIES; i++) { //Kullanıcının izlemediği filmler movieDistances ve movieIds arraylerine eklenir.
-        int movieId = i - USERS + 1;
-        if (!watchedMovies[movieId - 1] && distances[i] < FLT_MAX) {
-            movieDistances[movieCount] = distances[i];
-            movieIds[movieCount] = movieId;
-            movieCount++;
-        }
-    }
-
-    // Tüm filmler arasında mesafesi en kısa olanlar belirlenir.
-    float minDistance = FLT_MAX;
-    for (int i = 0; i < movieCount; i++) {
-        if (movieDistances[i] < minDistance) {
-            minDistance = movieDistances[i];
-        }
-    }
+    count = recommendSimilarItems(itemNeighbors, ratingMatrix, user, context->rec, worker->items, worker->movies);
+    batchWriteList(out, user, "item", worker->movies, count);
 
-    int closestCount = 0;
-    int closestMovies[MOVIES];   // en yakın mesafedekileri bir dizide saklarız
-    for (int i = 0; i < movieCount; i++) {
-        if (movieDistances[i] == minDistance) {
-            closestMovies[closestCount++] = movieIds[i];
-        }
+    if (worker->factors != NULL) {
+        count = recommendFactors(factorModel, ratingMatrix, user, context->rec, worker->factors, worker->movies);
+        batchWriteList(out, user, "mf", worker->movies, count);
     }
 
-    // Bu en yakın mesafedeki filmlerden rastgele öneriler yapar, bunu yapmadığımda hep en küçük numaralı filmleri önerdi ona çözüm olsun diye böyle yaptım.
-    if (closestCount > 0) {
-        srand(time(NULL));
-        for (int i = 0; i < rec && i < closestCount; i++) {
-            int randomIndex = rand() % closestCount;
-            printf("Film %d \n", closestMovies[randomIndex]);
-
-            // Seçilen filmi listeden çıkar
-            for (int j = randomIndex; j < closestCount - 1; j++) {
-                closestMovies[j] = closestMovies[j + 1];
-            }
-            closestCount--;
-        }
-    } else {
-        printf("Hicbir film bulunamadi.\n");
+    if (trendIndex != NULL) {
+        count = recommendTrending(trendIndex, ratingMatrix, user, context->rec, NULL, NULL, worker->movies);
+        batchWriteList(out, user, "trending", worker->movies, count);
     }
-
-    free(distances);
 }
 
-// Rastgele öneri (soru 1)
-void recommendRandom(int user, int rec) {
-    int watched[MOVIES + 1] = {0};
-    int totalMovies[MOVIES]; //izlenmemiş filmlerin idsini tutuyor
-    int movieCount = 0;
-
-    Node *current = userMovies[user]; // kullanıcının izlediği filmlerin başını gösteriyoruz
-    while (current != NULL) {
-        watched[current->movieId] = 1; //izlenen filmler 1 olarak işaretlenir
-        current = current->next;
-    }
+static void printUsage(const char *program) {
+    printf("Kullanim: %s [-f puanlar] [-S veri.snap] [-L bant[xsatir]] [-M model.mf] [-T gun] [-b ilk son [-k oneri] [-t thread] [-o dosya] [-s tohum]]\n", program);
+}
 
-    for (int i = 1; i <= MOVIES; i++) {
-        if (!watched[i]) { // izlenmeyen filmler 0 ya onları buluyoruz
-            totalMovies[movieCount++] = i; // izlenmeyen filmleri buraya ekliyoruz
+// Ana Fonksiyon
+int main(int argc, char *argv[]) {
+    const char *inputFile = "u.data";
+    const char *snapshotFile = NULL;
+
+    bool batchMode = false;
+    BatchConfig batchConfig = {1, 0, 0, "oneriler1.tsv"}; //aralık -b ile verilir
+    int batchRec = 10;
+    unsigned long long seed = (unsigned long long)time(NULL);
+    int lshBands = 0;  //-L verilirse benzer kullanıcı MinHash/LSH ile yaklaşık aranır
+    int lshRows = MINHASH_ROWS;
+    const char *modelFile = NULL;  //-M verilirse egit ile eğitilmiş modelden "mf" önerisi de yapılır
+    double halfLifeDays = 0;       //-T verilirse zamana bağlı popülerlikten "trending" önerisi de yapılır
+
+    // -b ilk son ile verilen kullanıcı aralığı için toplu mod çalışır
+    // -L bant[xsatir] ile benzer kullanıcı araması yaklaşık yapılır (bkz. minhash.h)
+    // -M model.mf ile gizil faktör modelinden öneri yapılır (bkz. mf.h)
+    // -T gun ile puanları gun yarı ömürle çürüyerek sayılan, son zamanlarda popüler filmler önerilir (bkz. trend.h)
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0 && i + 2 < argc) {
+            batchMode = true;
+            batchConfig.firstUser = atoi(argv[++i]);
+            batchConfig.lastUser = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            batchRec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            batchConfig.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            batchConfig.outputFile = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+            snapshotFile = argv[++i];
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            inputFile = argv[++i];
+        } else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) {
+            if (parseMinHashShape(argv[++i], &lshBands, &lshRows) != 0) {
+                printf("Gecersiz LSH boyutu: %s (ornek: 16 ya da 16x4)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+            modelFile = argv[++i];
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            halfLifeDays = atof(argv[++i]);
+            if (halfLifeDays <= 0) {
+                printf("Gecersiz yari omur: %s (gun)\n", argv[i]);
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
         }
     }
 
-    if (movieCount > 0) {
-        srand(time(NULL));
-        printf("\nSoru 1: Rastgele Film Onerileri: ");
-        for (int i = 0; i < rec && i < movieCount; i++) {
-            int randomIndex = rand() % movieCount;
-            printf("%d ", totalMovies[randomIndex]);
-        }
-        printf("\n");
+    // -S verilirse hazır snapshot kullanılır, yoksa u.data (ya da -f ile verilen dosya) okunup her şey baştan kurulur
+    if (snapshotFile) {
+        loadFromSnapshot(snapshotFile, inputFile, NULL);
     } else {
-        printf("Yeterli izlenmeyen film yok.\n");
+        loadRatingStore(inputFile); //puan deposunu kurar, en yakın film araması da bunun üzerinde çalışır
     }
-}
-
-// Derecesi en yüksek öneri (soru 2) Derecesi en yüksek yani en çok izlenen
-void recommendHighDegree(int user, int rec) {
-    int watched[MOVIES + 1] = {0};  // Tüm filmleri izlenip izlenmediğine göre takip eden array
-    int recommendedMovies[rec];  // Kullanıcıya önerilecek filmler
-    int maxDegrees[rec];  // Derecesi en yüksek olan filmleri tutacak array
-
-    // Başlangıçta, öneri listesinde -1 var, bir öneri yapılmadığı için
-
-    for (int i = 0; i < rec; i++) {
-        recommendedMovies[i] = -1;
-        maxDegrees[i] = -1;
+    if (lshBands > 0) {
+        userIndex = buildMinHashIndex(ratingMatrix, lshBands, lshRows, MINHASH_SEED, batchConfig.threads);
     }
-
-    Node *current = userMovies[user];
-    while (current != NULL) {
-        watched[current->movieId] = 1;  //kullanıcının izlediği filmler watched dizisine eklenir 1 olarak
-        current = current->next;
+    if (modelFile != NULL && (factorModel = loadFactorModel(modelFile, ratingMatrix)) == NULL) {
+        return 1;
     }
-
-    for (int movie = 1; movie <= MOVIES; movie++) {
-        if (!watched[movie]) {    //film izlenmemişse
-            int degree = movieDegree[movie]; //derecesini al
-
-// Dereceye göre en yüksek olan filmleri bulmak için bir iç döngü 
-            for (int i = 0; i < rec; i++) {
-                if (degree > maxDegrees[i]) {  // Eğer şu anki filmin derecesi daha yüksekse Önceki filmler sağa 
-                    for (int j = rec - 1; j > i; j--) {
-                        maxDegrees[j] = maxDegrees[j - 1];  // Dereceleri kaydır
-                        recommendedMovies[j] = recommendedMovies[j - 1];  // Filmleri kaydır
-                    }
-                    maxDegrees[i] = degree;  // Yeni filmin derecesi eklenir
-                    recommendedMovies[i] = movie;  // Film öneri listesine eklenir
-                    break;  // Yüksek dereceye sahip film bulunduğunda döngüden çıkılır
-                }
-            }
-        }  //insertion sort ama büyükten küçüğe sıralanmışı 
+    if (halfLifeDays > 0) {
+        trendIndex = buildTrendIndex(ratingMatrix, halfLifeDays);
     }
 
-
-    printf("Soru 2: Derecesi En Yuksek Filmlerden Oneriler: ");
-    for (int i = 0; i < rec; i++) {
-        if (recommendedMovies[i] != -1) {
-            printf("%d ", recommendedMovies[i]);
+    if (batchMode) {
+        if (batchConfig.firstUser < 1 || batchConfig.lastUser > numUsers || batchConfig.firstUser > batchConfig.lastUser) {
+            printf("Gecersiz kullanici araligi (1-%d).\n", numUsers);
+            return 1;
         }
-    }
-    printf("\n");
-}
-
-// Benzer kullanıcıyı bul
-int findMostSimilarUser(int targetUser) {
-    int commonMovies[USERS + 1] = {0}; //tüm kullanıcılar istenen kullanıcıya ne kadar benzer bulmak için
-
-    Node *targetMovies = userMovies[targetUser];
-    while (targetMovies != NULL) {
-        for (int user = 1; user <= USERS; user++) {
-            if (user == targetUser) continue;
-
-            Node *current = userMovies[user];
-            while (current != NULL) {
-               if (current->movieId == targetMovies->movieId) {  // Eğer "targetUser" ile ortak bir film bulunursa:
-                    commonMovies[user]++;  // Bu kullanıcının ortak film sayısı artırılır.
-                    break;
-                }
-                current = current->next;
-            }
-        }
-        targetMovies = targetMovies->next;
-    }
-
-    int maxCommon = -1;
-    int mostSimilarUser = -1;
-    for (int user = 1; user <= USERS; user++) {
-        if (commonMovies[user] > maxCommon) {
-            maxCommon = commonMovies[user];     //en çok benzeyen kullanıcı olmak için kullanıcılar karşılaştırılır
-            mostSimilarUser = user;
+        if (batchRec < 1) {
+            printf("Gecersiz oneri sayisi.\n");
+            return 1;
         }
-    }
-
-    return mostSimilarUser;
-}
-
-// Benzer kullanıcı önerileri
-void recommendFromSimilarUser(int targetUser, int similarUser, int rec) {
-// Benzer kullanıcının 5 puan verdiği ve "targetUser" tarafından izlenmeyen filmleri öneren fonksiyon başlıyor.
-
-    int watched[MOVIES + 1] = {0};
-
-    Node *current = userMovies[targetUser];
-    while (current != NULL) {
-        watched[current->movieId] = 1;
-        current = current->next;
-    }
-
-    Node *similarMovies = userMovies[similarUser];
-    printf("Benzer Kullanicinin 5 Puan Verdigi Oneriler: ");
-    int found = 0;
-    int recommendationsCount = 0;
-
-    while (similarMovies != NULL) {
-        if (similarMovies->rating == 5 && !watched[similarMovies->movieId]) {
-    // Eğer bulduğumuz benzer kullanıcı 5 puan vermişse ve bu film kullanıcımız (targetu)tarafından izlenmemişse doğru olur
-
-            printf("%d ", similarMovies->movieId);
-            found = 1;
-            recommendationsCount++;
+        if (batchRec > numMovies) {
+            batchRec = numMovies;  //çalışma alanları öneri sayısı kadar ayrılır
         }
 
-        if (recommendationsCount == rec) {
-            break;
+        BatchContext context = {batchRec, seed};
+        BatchHooks hooks = {batchThreadInit, batchProcessUser, batchThreadFree};
+        int result = runBatch(&batchConfig, &hooks, &context);
+        if (result == 0) {
+            printf("%d kullanici icin oneriler %s dosyasina yazildi.\n",
+                   batchConfig.lastUser - batchConfig.firstUser + 1, batchConfig.outputFile);
         }
 
-        similarMovies = similarMovies->next;
+        metricsDump(stderr);
+        freeRatingStore();
+        return result == 0 ? 0 : 1;
     }
 
-    if (!found) {
-        printf("Hicbir oneri bulunamadi.\n");
-    }
-    printf("\n");
-}
-
-// Hafızayı temizle
-void freeGraph() {
-    for (int i = 1; i <= USERS; i++) {
-        Node *current = userMovies[i];
-        while (current != NULL) {
-            Node *temp = current;
-            current = current->next;
-            free(temp);
-        }
-        userMovies[i] = NULL;
-    }
-}
-
-// Ana Fonksiyon
-int main() {
-    const char *inputFile = "u.data";
-    const char *outputFile = "interactions.txt";
-
-    Graph *graph = createGraph(MAX_VERTICES);
-    bool watchedMovies[MOVIES] = {false};
-
-    createRecommendationsFile(inputFile, outputFile);
-
     int user;
     int rec;
-    printf("Film onerisi almak istediginiz kullanici ID'sini girin (1-%d): ", USERS);
+    printf("Film onerisi almak istediginiz kullanici ID'sini girin (1-%d): ", numUsers);
     scanf("%d", &user);
 
     printf("Kac tane oneri almak istiyorsaniz girin: ");
     scanf("%d", &rec);
 
-    if (user < 1 || user > USERS) {
+    if (user < 1 || user > numUsers) {
         printf("Gecersiz kullanici ID'si.\n");
         return 1;
     }
+    if (rec < 1) {
+        printf("Gecersiz oneri sayisi.\n");
+        return 1;
+    }
+    if (rec > numMovies) {
+        rec = numMovies;
+    }
 
-    buildGraphFromFile(outputFile, graph, watchedMovies, user); //void addEdge fonksiyonunu da içinde kullanarak graphımızı oluşturur
+    Rng rng;
+    rngSeed(&rng, seed);
+    int *movies = (int *)malloc(rec * sizeof(int));
+    ScoredItem *best = (ScoredItem *)malloc(rec * sizeof(ScoredItem));
 
     // Rastgele Oneriler
-    recommendRandom(user, rec);
+    int count = recommendRandom(user, rec, &rng, movies);
+    if (count > 0) {
+        printf("\nSoru 1: Rastgele Film Onerileri: ");
+        for (int i = 0; i < count; i++) {
+            printf("%d ", movies[i]);
+        }
+        printf("\n");
+    } else {
+        printf("Yeterli izlenmeyen film yok.\n");
+    }
     printf("\n");
 
 
 
     // Derecesi En Yuksek Filmler
-    recommendHighDegree(user, rec);
+    count = recommendHighDegree(user, rec, best, movies);
+    printf("Soru 2: Derecesi En Yuksek Filmlerden Oneriler: ");
+    for (int i = 0; i < count; i++) {
+        printf("%d ", movies[i]);
+    }
+    printf("\n");
 
 
     
-    int similarUser = findMostSimilarUser(user);
+    MinHashScratch *similar = userIndex != NULL ? createMinHashScratch(numUsers) : NULL;
+    int similarUser = similar != NULL ? findSimilarUserApprox(user, similar) : findMostSimilarUser(user);
+    if (similar != NULL) {
+        freeMinHashScratch(similar);
+    }
     if (similarUser != -1) {
         printf("\nSoru 3: Benzer Kullanici (%d) Onerileri:\n", similarUser);
-        recommendFromSimilarUser(user, similarUser, rec);
+        count = recommendFromSimilarUser(user, similarUser, rec, movies);
+        printf("Benzer Kullanicinin 5 Puan Verdigi Oneriler: ");
+        for (int i = 0; i < count; i++) {
+            printf("%d ", movies[i]);
+        }
+        if (count == 0) {
+            printf("Hicbir oneri bulunamadi.\n");
+        }
+        printf("\n");
 
     }
 
     printf("\nSoru 4: En Yakin Mesafedeki Filmlerden Oneriler:\n");
-    recommendNearestMovies(graph, user, watchedMovies, rec);
+    DijkstraScratch *scratch = createDijkstraScratch(ratingMatrix);
+    count = recommendNearestMovies(user, rec, scratch, movies);
+    for (int i = 0; i < count; i++) {
+        printf("Film %d \n", movies[i]);
+    }
+    if (count == 0) {
+        printf("Hicbir film bulunamadi.\n");
+    }
+
+    printf("\nSoru 5: Begendiginiz Filmlere Benzeyen Filmlerden Oneriler: ");
+    ItemScratch *items = createItemScratch(numMovies);
+    count = recommendSimilarItems(itemNeighbors, ratingMatrix, user, rec, items, movies);
+    for (int i = 0; i < count; i++) {
+        printf("%d ", movies[i]);
+    }
+    if (count == 0) {
+        printf("Hicbir film bulunamadi.");
+    }
+    printf("\n");
 
+    if (factorModel != NULL) {
+        printf("\nSoru 6: Gizli Faktor Modelinden Oneriler: ");
+        FactorScratch *factors = createFactorScratch(numMovies);
+        count = recommendFactors(factorModel, ratingMatrix, user, rec, factors, movies);
+        for (int i = 0; i < count; i++) {
+            printf("%d ", movies[i]);
+        }
+        if (count == 0) {
+            printf("Hicbir film bulunamadi.");
+        }
+        printf("\n");
+        freeFactorScratch(factors);
+    }
+
+    if (trendIndex != NULL) {
+        printf("\nSoru 7: Son Zamanlarda Populer Filmlerden Oneriler: ");
+        count = recommendTrending(trendIndex, ratingMatrix, user, rec, NULL, NULL, movies);
+        for (int i = 0; i < count; i++) {
+            printf("%d ", movies[i]);
+        }
+        if (count == 0) {
+            printf("Hicbir film bulunamadi.");
+        }
+        printf("\n");
+    }
 
-    freeGraph();
+    metricsDump(stderr);
+    freeItemScratch(items);
+    freeDijkstraScratch(scratch);
+    free(best);
+    free(movies);
+    freeRatingStore();
     return 0;
 }
 
@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "recommend1.h"
+#include "loader.h"
+#include "snapshot.h"
+#include "topk.h"
+#include "metrics.h"
+
+// Global değişkenler (boyutlar yüklenen veriden gelir)
+int numUsers = 0;
+int numMovies = 0;
+RatingMatrix *ratingMatrix = NULL; //kullanıcı x film puanları (0 tabanlı, seyrek): tüm yöntemlerin okuduğu tek depo
+ItemNeighbors *itemNeighbors = NULL;
+MinHashIndex *userIndex = NULL;
+FactorModel *factorModel = NULL;
+TrendIndex *trendIndex = NULL;
+static Snapshot snapshot = {0};    //-S ile açılan snapshot; açıksa matris onun içini gösterir
+
+// Puan deposunu dosyadan kur
+// u.data bellek eşlemeyle okunup puan dizisine çevrilir (ara dosya yazılmaz), depo bu diziden kurulur.
+void loadRatingStore(const char *fileName) {
+    METRICS_BEGIN(PHASE_LOAD);
+    RatingSet set;
+    if (loadRatings(fileName, 0, &set) != 0) {
+        printf("Dosya acilamadi: %s\n", fileName);
+        exit(1);
+    }
+    if (set.maxUser < 1 || set.maxMovie < 1) {
+        printf("Dosyada puan yok: %s\n", fileName);
+        exit(1);
+    }
+    loadRatingStoreFromSet(&set);
+    freeRatingSet(&set);
+    METRICS_END(PHASE_LOAD);
+}
+
+// Bellekteki puan dizisinden kurar; kullanıcı ve film sayıları set->maxUser / set->maxMovie'dir
+// (değerlendirmede eğitim parçası tüm verinin boyutlarıyla verilir, hiç puanı kalmayan filmler de yer alır)
+void loadRatingStoreFromSet(const RatingSet *set) {
+    numUsers = set->maxUser;
+    numMovies = set->maxMovie;
+    METRICS_BEGIN(PHASE_GRAPH_BUILD);
+    ratingMatrix = buildRatingMatrix(set, numUsers, numMovies);
+    METRICS_END(PHASE_GRAPH_BUILD);
+    itemNeighbors = buildItemNeighbors(ratingMatrix, ITEM_NEIGHBORS, 0);
+}
+
+// Puan deposunu derle ile hazırlanmış snapshot'tan al
+// Matris ve film-film komşuları doğrudan eşlenmiş dosyadan okunur, kurulacak bir şey kalmaz.
+// ratingsFile ya da itemsFile (NULL olabilir) snapshot'tan sonra değişmişse snapshot reddedilir.
+// Açılan snapshot döner; türleri de isteyenler (sunucu, olcum) onu load_genres_from_snapshot'a verir.
+const Snapshot *loadFromSnapshot(const char *fileName, const char *ratingsFile, const char *itemsFile) {
+    METRICS_BEGIN(PHASE_LOAD);
+    if (openSnapshot(fileName, ratingsFile, itemsFile, &snapshot) != 0) {
+        exit(1);
+    }
+    numUsers = snapshot.users;
+    numMovies = snapshot.movies;
+    ratingMatrix = &snapshot.matrix;
+    itemNeighbors = &snapshot.items;
+    METRICS_END(PHASE_LOAD);
+    return &snapshot;
+}
+
+// En yakın filmleri bul ve belirli bir sayı öner
+// Önerilen filmler out dizisine yazılır, öneri sayısı döner
+// Eskiden tüm düğümlere dijkstra yapılıp sadece en yakın mesafedekiler arasından rastgele seçiliyordu; artık
+// arama rec izlenmemiş film bulununca durur (bkz. nearestUnseenMovies) ve filmler mesafeye göre sıralı gelir,
+// eşit mesafede küçük id'li film önce. İzlenen filmler kullanıcının grafikteki komşularıdır.
+int recommendNearestMovies(int userId, int rec, DijkstraScratch *scratch, int *out) {
+    METRICS_BEGIN(PHASE_NEAREST);
+    int count = nearestUnseenMovies(ratingMatrix, userId - 1, rec, scratch, out);
+    for (int i = 0; i < count; i++) {
+        out[i] = out[i] - numUsers + 1;  //film düğümünden film id'sine
+    }
+    METRICS_END(PHASE_NEAREST);
+    return count;
+}
+
+// Rastgele öneri (soru 1)
+// İzlenmemiş filmler listesi kurulmaz: sırası r olan izlenmemiş film, kullanıcının sıralı satırından bulunur
+// (r'den başlanır, o ana kadarki sonuçtan küçük ya da eşit her izlenmiş film sonucu bir ileri kaydırır).
+// Seçim başına O(izlenen film), film sayısı kadar yer gerekmez.
+int recommendRandom(int user, int rec, Rng *rng, int *out) {
+    METRICS_BEGIN(PHASE_RANDOM);
+    int watchedCount;
+    const int *watched = userRow(ratingMatrix, user - 1, &watchedCount);  //izlenen filmler (0 tabanlı, artan)
+    int movieCount = numMovies - watchedCount; //izlenmemiş film sayısı
+
+    int count = 0;
+    for (int i = 0; i < rec && i < movieCount; i++) {
+        int movie = rngRange(rng, movieCount);  // izlenmeyenler arasındaki sırası
+        for (int j = 0; j < watchedCount && watched[j] <= movie; j++) {
+            movie++;
+        }
+        out[count++] = movie + 1;
+    }
+    METRICS_END(PHASE_RANDOM);
+    return count;
+}
+
+// Derecesi en yüksek öneri (soru 2) Derecesi en yüksek yani en çok izlenen
+// Filmin derecesi, puan veren sayısı olarak depoda zaten tutuluyor (movieCount)
+// best en az rec elemanlık çalışma alanıdır (iş parçacığı başına bir tane), derecesi en yüksek filmleri tutan yığın
+int recommendHighDegree(int user, int rec, ScoredItem *best, int *out) {
+    METRICS_BEGIN(PHASE_HIGH_DEGREE);
+    TopK topk;
+    topkInit(&topk, best, rec);
+
+    for (int movie = 1; movie <= numMovies; movie++) {
+        if (!hasRated(ratingMatrix, user - 1, movie - 1)) {    //film izlenmemişse
+            topkPush(&topk, movie, ratingMatrix->movieCount[movie - 1]);  // derecesi en küçükten yüksekse listeye girer
+        }
+    }
+    // eşit derecelerde küçük id'li film önce gelir
+
+    int count = topkFinish(&topk);
+    for (int i = 0; i < count; i++) {
+        out[i] = best[i].id;
+    }
+    METRICS_END(PHASE_HIGH_DEGREE);
+    return count;
+}
+
+// Benzer kullanıcıyı bul
+// Ortak film sayıları iki yoldan biriyle hesaplanır, ikisi de aynı sonucu verir:
+//  - ters indeks: hedefin her filmi için sadece o filmi izleyenler (matrisin film sütunu) gezilir,
+//    iş miktarı hedefin filmlerinin derecelerinin toplamı kadar
+//  - bit matrisi: hedefin bit satırı her kullanıcının satırıyla AND'lenip bitleri sayılır (popcount),
+//    iş miktarı kullanıcı sayısı x satırdaki kelime sayısı kadar ama bellekte sırayla ilerler
+// Hangisi daha az iş gerektiriyorsa o seçilir; bit düzlemleri kurulmadıysa (büyük veri) hep ters indeks.
+int findMostSimilarUser(int targetUser) {
+    METRICS_BEGIN(PHASE_SIMILAR_USER);
+    int *commonMovies = (int *)calloc(numUsers + 1, sizeof(int)); //tüm kullanıcılar istenen kullanıcıya ne kadar benzer bulmak için
+
+    int watchedCount;
+    const int *watched = userRow(ratingMatrix, targetUser - 1, &watchedCount);
+    long indexWork = 0;
+    for (int i = 0; i < watchedCount; i++) {
+        indexWork += ratingMatrix->movieCount[watched[i]];
+    }
+    long bitWork = (long)numUsers * ratingMatrix->wordsPerRow;
+
+    if (ratingMatrix->wordsPerRow > 0 && bitWork < indexWork) {  //bit düzlemleri büyük veride kurulmaz
+        cowatchOneVsAll(ratingMatrix, targetUser - 1, commonMovies + 1);
+        commonMovies[targetUser] = 0; //kullanıcının kendisiyle benzerliği sayılmaz
+        METRICS_ADD(METRIC_SIMILAR_BIT_WORDS, bitWork);
+    } else {
+        // Ters indeks olarak matrisin film sütunları kullanılır: bağlı liste yerine bitişik diziler
+        for (int i = 0; i < watchedCount; i++) {
+            int raterCount;
+            const int *raters = movieColumn(ratingMatrix, watched[i], &raterCount);
+            for (int j = 0; j < raterCount; j++) {
+                commonMovies[raters[j] + 1]++;  // "targetUser" ile ortak bir film, bu kullanıcının ortak film sayısı artırılır.
+            }
+        }
+        commonMovies[targetUser] = 0; //kullanıcının kendisiyle benzerliği sayılmaz
+        METRICS_ADD(METRIC_SIMILAR_LIST_NODES, indexWork);
+    }
+
+    int maxCommon = -1;
+    int mostSimilarUser = -1;
+    for (int user = 1; user <= numUsers; user++) {
+        if (commonMovies[user] > maxCommon) {
+            maxCommon = commonMovies[user];     //en çok benzeyen kullanıcı olmak için kullanıcılar karşılaştırılır
+            mostSimilarUser = user;
+        }
+    }
+
+    free(commonMovies);
+    METRICS_END(PHASE_SIMILAR_USER);
+    return mostSimilarUser;
+}
+
+// Yaklaşık benzer kullanıcı: userIndex'in LSH adayları arasında film kümeleri en çok örtüşen (Jaccard)
+// kullanıcı. Ortak film sayısına değil Jaccard'a baktığı için findMostSimilarUser'dan farklı kullanıcı
+// seçebilir; çok film izleyen kullanıcılar kendiliğinden öne geçmez. Aday çıkmazsa kesin Jaccard aranır.
+int findSimilarUserApprox(int targetUser, MinHashScratch *scratch) {
+    METRICS_BEGIN(PHASE_SIMILAR_USER);
+    int similar = -1;
+    if (findSimilarUsersLsh(userIndex, ratingMatrix, targetUser - 1, 1, scratch, &similar, NULL, NULL) == 0 &&
+        findSimilarUsersExact(ratingMatrix, targetUser - 1, 1, scratch, &similar, NULL) == 0) {
+        similar = -2;  //hiç ortak filmi olan yok
+    }
+    METRICS_END(PHASE_SIMILAR_USER);
+    return similar + 1;
+}
+
+// Benzer kullanıcı önerileri
+// Benzer kullanıcının satırı film id'sine göre sıralı olduğu için öneriler de küçük id'den büyüğe gelir
+int recommendFromSimilarUser(int targetUser, int similarUser, int rec, int *out) {
+    METRICS_BEGIN(PHASE_FROM_SIMILAR);
+// Benzer kullanıcının 5 puan verdiği ve "targetUser" tarafından izlenmeyen filmleri öneren fonksiyon başlıyor.
+
+    int similarCount;
+    const int *similarMovies = userRow(ratingMatrix, similarUser - 1, &similarCount);
+    const unsigned char *similarRatings = ratingMatrix->rowRatings + ratingMatrix->rowOffsets[similarUser - 1];
+    int recommendationsCount = 0;
+
+    for (int i = 0; i < similarCount && recommendationsCount < rec; i++) {
+        if (similarRatings[i] == 5 && !hasRated(ratingMatrix, targetUser - 1, similarMovies[i])) {
+    // Eğer bulduğumuz benzer kullanıcı 5 puan vermişse ve bu film kullanıcımız (targetu)tarafından izlenmemişse doğru olur
+
+            out[recommendationsCount++] = similarMovies[i] + 1;
+        }
+    }
+
+    METRICS_END(PHASE_FROM_SIMILAR);
+    return recommendationsCount;
+}
+
+// Hafızayı temizle
+// Snapshot açıldıysa dosya eşlemesi de kapatılır (depo canlı güncelleme için kopyalanmış olsa da
+// film-film komşuları hâlâ onun içindedir)
+void freeRatingStore(void) {
+    if (ratingMatrix != NULL && ratingMatrix != &snapshot.matrix) {
+        freeRatingMatrix(ratingMatrix);
+    }
+    ratingMatrix = NULL;
+    freeItemNeighbors(itemNeighbors);  //snapshot'ın içindeyse bir şey yapmaz
+    itemNeighbors = NULL;
+    closeSnapshot(&snapshot);          //açık değilse bir şey yapmaz
+    freeMinHashIndex(userIndex);
+    userIndex = NULL;
+    freeFactorModel(factorModel);
+    factorModel = NULL;
+    freeTrendIndex(trendIndex);
+    trendIndex = NULL;
+}
+
+// Canlı güncelleme için matris, yerinde eklemeye izin veren kopyasıyla değiştirilir.
+// Dosyadan kurulduysa eskisi bırakılır; snapshot'takinin sayfaları artık okunmaz, eşleme kapanışa kadar durur.
+void makeDataGrowable(void) {
+    RatingMatrix *matrix = copyGrowableMatrix(ratingMatrix);
+    if (ratingMatrix != &snapshot.matrix) {
+        freeRatingMatrix(ratingMatrix);
+    }
+    ratingMatrix = matrix;
+}
@@ -0,0 +1,40 @@
+#ifndef RECOMMEND1_H
+#define RECOMMEND1_H
+
+#include "rng.h"
+#include "bitmatrix.h"
+#include "graph.h"
+#include "itemsim.h"
+#include "minhash.h"
+#include "mf.h"
+#include "trend.h"
+#include "snapshot.h"
+
+// oneri1'in öneri yöntemleri ve kullandıkları veri (puan deposu, film-film komşuları; film-film önerisinin
+// kendisi itemsim.h'de). oneri1, sunucu ve diğer araçlar aynı kodu buradan kullanır.
+// Tüm yöntemler puanları tek bir depodan (ratingMatrix, bkz. bitmatrix.h) okur: kullanıcının filmleri satırı,
+// filmin dereceleri movieCount, en yakın film araması da aynı satır ve sütunlar üzerinde yürür (bkz. graph.h).
+// Kullanıcı ve film sayıları derlemede sabit değildir, yüklenen veriden (en büyük id) bulunur.
+
+extern int numUsers;
+extern int numMovies;
+extern RatingMatrix *ratingMatrix;
+extern ItemNeighbors *itemNeighbors; //film-film komşuları (snapshot varsa ondan, yoksa yüklemede kurulur)
+extern MinHashIndex *userIndex;      //yaklaşık benzer kullanıcı dizini, sadece -L ile kurulur
+extern FactorModel *factorModel;     //egit ile eğitilmiş gizil faktör modeli, sadece -M ile açılır
+extern TrendIndex *trendIndex;       //zamana bağlı popülerlik dizini, sadece -T ile kurulur
+
+// Fonksiyon Bildirimleri
+void loadRatingStore(const char *fileName);
+void loadRatingStoreFromSet(const RatingSet *set);
+const Snapshot *loadFromSnapshot(const char *fileName, const char *ratingsFile, const char *itemsFile);
+void makeDataGrowable(void);
+int recommendNearestMovies(int userId, int rec, DijkstraScratch *scratch, int *out);
+int recommendRandom(int user, int rec, Rng *rng, int *out);
+int recommendHighDegree(int user, int rec, ScoredItem *best, int *out);
+int findMostSimilarUser(int targetUser);
+int findSimilarUserApprox(int targetUser, MinHashScratch *scratch);
+int recommendFromSimilarUser(int targetUser, int similarUser, int rec, int *out);
+void freeRatingStore(void);
+
+#endif
@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "recommend2.h"
+#include "loader.h"
+#include "snapshot.h"
+#include "topk.h"
+#include "metrics.h"
+
+// Veriden bulunan kullanıcı ve film sayısı
+int num_users;
+int num_movies;
+
+// Kullanıcılar x Filmler için adjacency matrix (Bipartite Graph)
+RatingMatrix *bipartite_matrix;  // Kullanıcılar ve Filmler arasındaki ilişkiyi gösterir
+
+/**adjency matrix kullandım çünkü Hızlı erişim: Bir kullanıcının bir filmi izleyip izlemediğini
+ *  kontrol etmek için O(1) zaman karmaşıklığı. Aşırı büyük boyutlu dosyalar kullanmazsan daha hızlı 
+ * 943 × 1682 = 1,586,626 hücre Her hücre için 4 bayt (int) kullanırsak: 6 MB bellek gereklidir.
+ * bizim için çok sorun yaratacak bir hafıza kaplamıyor daha hızlı olacağı için bunu kullandım
+ * ama şunu unutmamak lazım bir kullanıcı 1682 filmin çok çok büyük bir kısmını izlemediği için baya boş kutucuk kalacak
+ * (bir de diğerlerinde hep adjency list kullandım diye farklı olsun istedim açıkası**/
+
+//Eğer bir kullanıcı bir filmi izlediyse o hücrede verdiği rating tutulur, izlemediyse 0 tutulut
+// Büyük veride (MovieLens 10M/25M) yoğun tablo yüzlerce GB tutacağı için puanlar artık seyrek satırlarda
+// (sadece verilmiş puanlar) duruyor. "İzledi mi" sorusu için sığıyorsa hücre başına 1 bit'lik bir düzlem
+// var (~200 KB), izleme kontrolleri hasRated ile yapılıyor (bkz. bitmatrix.h).
+
+// Filmlerin türlerini tutan dizi, toplam 19 tür var bir film birden fazla tür olabilir
+// Her film için tek bir bit maskesi: i. bit 1 ise film i. türdendir (film başına 76 yerine 4 bayt)
+unsigned int *movie_genres;  // film sayısı kadar
+
+// Türlerin isimleri
+const char *genres[MAX_GENRES] = {
+    "Unknown", "Action", "Adventure", "Animation", "Children's", "Comedy", "Crime", "Documentary", 
+    "Drama", "Fantasy", "Film-Noir", "Horror", "Musical", "Mystery", "Romance", "Sci-Fi", "Thriller", 
+    "War", "Western"
+};
+
+// Rastgele yürüyüş için her düğümün puan ağırlıklı alias tablosu (grafiğin kenarları matrisin satır ve sütunları)
+WalkTable *walk_table;
+
+// -p ile verilen Bayes ortalaması ağırlığı; 0 ise düz ortalama kullanılır
+double bayes_prior = 0;
+
+// -S ile açılan snapshot; açıksa bipartite_matrix onun içini gösterir
+static Snapshot snapshot = {0};
+
+// Matris oneri1 ile paylaşılıyorsa (sunucu, olcum, degerlendir) belleği burada bırakılmaz
+static int shared_data = 0;
+
+// Kullanıcının hangi filmi ne kadar izlediğini tutar
+int (*user_genre_count)[MAX_GENRES];
+
+// Her türün filmleri, öneri puanına göre azalan sırada (eşit puanda küçük id önce) tek dizide art arda durur:
+// g. türün listesi genre_postings[genre_offsets[g]] ile genre_postings[genre_offsets[g + 1]] arası.
+// Puanlar recommend_movies'in kullandığı ortalamayla (bayes_prior'a göre) aynıdır, yüklemede bir kez hesaplanır
+static int genre_offsets[MAX_GENRES + 1];
+static ScoredItem *genre_postings = NULL;
+
+double genre_score(int movie_id) {
+    // Ortalama rating yükleme sırasında tutulan film toplamlarından gelir, bütün kullanıcıları taramaya gerek yok
+    // bayes_prior verildiyse az puan almış filmler genel ortalamaya doğru çekilir
+    return bayes_prior > 0 ? movieBayesMean(bipartite_matrix, movie_id, bayes_prior)
+                           : movieMean(bipartite_matrix, movie_id);
+}
+
+static void build_genre_tables(void);
+
+// Kullanıcının izlediği filmlerin türlerinr bakar her türden ne kadar film izlemiş counts dizisine saklar
+// (genelde user_genre_count[user_id]). Sadece counts'a yazdığı için aynı anda birden çok yerden çağrılabilir
+// Tüm filmler yerine sadece kullanıcının satırındaki (izlediği) filmler gezilir.
+void count_user_genres(int user_id, int *counts) {
+    for (int j = 0; j < MAX_GENRES; j++) {
+        counts[j] = 0;
+    }
+    int watched_count;
+    const int *watched = userRow(bipartite_matrix, user_id, &watched_count);
+    for (int k = 0; k < watched_count; k++) {
+        for (unsigned int mask = movie_genres[watched[k]]; mask != 0; mask &= mask - 1) {
+            counts[__builtin_ctz(mask)]++;  // sadece filmin türleri (1 olan bitler) gezilir
+        }
+    }
+}
+
+// Kullanıcıların en çok izlediği türü bulma
+void find_favorite_genre(const int *counts, int *favorite_genre, int *max_count) {
+    *max_count = 0;
+    *favorite_genre = -1;
+
+    // Türlerin sayısını kontrol et ve en çok izlenen türü bul
+    for (int i = 0; i < MAX_GENRES; i++) {
+        if (counts[i] > *max_count) {  // her tür için tek tek bakar ve en çok izleneni bulur
+            *max_count = counts[i];
+            *favorite_genre = i;
+        }  //counts dizisindeki en büyük değeri arar.
+    }
+}
+//Döngü tamamlandığında: *favorite_genre: Kullanıcının en çok izlediği türün indeksini (örneğin, 1 → "Action") içerir.
+//*max_count: Bu türde kaç film izlendiğini içerir.
+
+
+// Boyutlar belli olunca tür tabloları ayrılır
+static void allocate_tables(int users, int movies) {
+    num_users = users;
+    num_movies = movies;
+    movie_genres = calloc(movies, sizeof(*movie_genres));
+    user_genre_count = calloc(users, sizeof(*user_genre_count));
+}
+
+// Adjacency Matrix Yapısı ile Graph Oluşturma 
+void build_bipartite_matrix(const char *filename) {
+    METRICS_BEGIN(PHASE_LOAD);
+    RatingSet set;
+    if (loadRatings(filename, 0, &set) != 0) {  //dosya bellek eşlemeyle okunur
+        printf("Veri dosyasi acilamadi!\n");
+        exit(1);
+    } //u.data dosyasını okuyarak kullanıcıların izlediği filmleri ve verdikleri ratingleri matrise işler.
+    if (set.maxUser < 1 || set.maxMovie < 1) {
+        printf("Veri dosyasinda puan yok!\n");
+        exit(1);
+    }
+
+    build_bipartite_matrix_from_set(&set);
+    freeRatingSet(&set);
+    METRICS_END(PHASE_LOAD);
+}
+
+// Bellekteki puan dizisinden kurar (boyutlar set->maxUser / set->maxMovie)
+void build_bipartite_matrix_from_set(const RatingSet *set) {
+    allocate_tables(set->maxUser, set->maxMovie);
+    bipartite_matrix = buildRatingMatrix(set, num_users, num_movies);  // Kullanıcı ve filmi ilişkilendiriyoruz (diziler 0dan başlıyor)
+    walk_table = createWalkTable(bipartite_matrix);  // yürüyüş aynı puanlar üzerinde kenar kenar ilerler
+}
+
+// Film türlerini okuyarak ilişkileri bipartite_matrix ile eşleştirme
+void build_movie_genres(const char *filename) {  //u.item
+    METRICS_BEGIN(PHASE_LOAD);
+    MovieGenres movies;
+    if (loadMovieGenres(filename, &movies) != 0) {
+        printf("Film turleri dosyasi acilamadi!\n");
+        exit(1);
+    }
+
+    // u.item '|' ile ayrılmış, türler 5. alandan sonra geliyor; yükleyici bunları bit maskesi olarak veriyor
+    for (int movie_id = 1; movie_id <= movies.maxMovie && movie_id <= num_movies; movie_id++) {
+        movie_genres[movie_id - 1] = movies.genres[movie_id] & ((1u << MAX_GENRES) - 1);  // Film türlerini ilişkilendiriyoruz
+    }
+
+    freeMovieGenres(&movies);
+    build_genre_tables();
+    METRICS_END(PHASE_LOAD);
+}
+
+// Matris ve türleri derle ile hazırlanmış snapshot'tan al (metin dosyası okunmaz)
+void load_from_snapshot(const char *filename, const char *ratings_file, const char *items_file) {
+    METRICS_BEGIN(PHASE_LOAD);
+    if (openSnapshot(filename, ratings_file, items_file, &snapshot) != 0) {
+        exit(1);
+    }
+
+    allocate_tables(snapshot.users, snapshot.movies);
+    bipartite_matrix = &snapshot.matrix;
+    walk_table = createWalkTable(bipartite_matrix);
+    load_genres_from_snapshot(&snapshot);
+    METRICS_END(PHASE_LOAD);
+}
+
+// Türleri başka bir modülün açtığı snapshot'ın tür bölümünden alır (build_movie_genres'in snapshot karşılığı).
+// sunucu ve olcum snapshot'ı oneri1'in deposuyla bir kez açar, share_rating_data'dan sonra bunu çağırır;
+// dosya ikinci kez açılıp sağlaması yeniden hesaplanmaz.
+void load_genres_from_snapshot(const Snapshot *source) {
+    for (int movie_id = 1; movie_id <= num_movies && movie_id <= source->movies; movie_id++) {
+        movie_genres[movie_id - 1] = source->genres[movie_id] & ((1u << MAX_GENRES) - 1);
+    }
+    build_genre_tables();
+}
+
+// Matrisin belleğini bırakır (snapshot'tan geldiyse dosya eşlemesini kapatır)
+void free_bipartite_matrix(void) {
+    freeWalkTable(walk_table);
+    if (bipartite_matrix == &snapshot.matrix) {
+        closeSnapshot(&snapshot);
+    } else if (!shared_data) {
+        freeRatingMatrix(bipartite_matrix);
+    }
+    bipartite_matrix = NULL;
+    walk_table = NULL;
+    shared_data = 0;
+    free(movie_genres);
+    free(user_genre_count);
+    free(genre_postings);
+    movie_genres = NULL;
+    user_genre_count = NULL;
+    genre_postings = NULL;
+}
+
+// Kendi matrisi yerine oneri1'in puan deposunu kullanır; iki programın yöntemleri aynı süreçte çalışınca
+// (sunucu, olcum, degerlendir) puanlar bellekte bir kez durur, canlı güncellemede de tek kopyaya işlenir.
+// Henüz yükleme yapılmadıysa tablolar matrisin boyutlarıyla ayrılır, türler sonra build_movie_genres ile okunur.
+// Daha önce yüklendiyse (snapshot) türler ve tür sayıları aynen kalır, oneri1 ile aynı puanlardan kurulmuş olmalı.
+void share_rating_data(RatingMatrix *matrix) {
+    freeWalkTable(walk_table);
+    if (bipartite_matrix == &snapshot.matrix) {
+        closeSnapshot(&snapshot);
+    } else if (bipartite_matrix != NULL && !shared_data) {
+        freeRatingMatrix(bipartite_matrix);
+    }
+    if (movie_genres == NULL) {
+        allocate_tables(matrix->users, matrix->movies);
+    }
+    bipartite_matrix = matrix;
+    walk_table = createWalkTable(bipartite_matrix);
+    shared_data = 1;
+}
+
+// Tüm kullanıcıların tür sayılarını user_genre_count'a doldurur
+void build_user_genre_counts(void) {
+    for (int user_id = 0; user_id < num_users; user_id++) {
+        count_user_genres(user_id, user_genre_count[user_id]);
+    }
+}
+
+// Kullanıcı yeni bir film izleyince (delta 1) o filmin türlerinin sayısı artar
+void add_user_genres(int user_id, int movie_id, int delta) {
+    for (unsigned int mask = movie_genres[movie_id]; mask != 0; mask &= mask - 1) {
+        user_genre_count[user_id][__builtin_ctz(mask)] += delta;
+    }
+}
+
+// qsort için: yüksek puan önce, eşit puanda küçük id önce (TopK ile aynı sıra)
+static int compare_postings(const void *a, const void *b) {
+    ScoredItem x = *(const ScoredItem *)a;
+    ScoredItem y = *(const ScoredItem *)b;
+    if (betterItem(x, y)) {
+        return -1;
+    }
+    return betterItem(y, x) ? 1 : 0;
+}
+
+// genre_mask'taki türlerin listelerindeki puanları yeniden hesaplayıp listeleri yeniden sıralar
+void refresh_genre_postings(unsigned int genre_mask) {
+    for (unsigned int mask = genre_mask & ((1u << MAX_GENRES) - 1); mask != 0; mask &= mask - 1) {
+        int genre = __builtin_ctz(mask);
+        ScoredItem *list = genre_postings + genre_offsets[genre];
+        int length = genre_offsets[genre + 1] - genre_offsets[genre];
+        for (int i = 0; i < length; i++) {
+            list[i].score = genre_score(list[i].id);
+        }
+        qsort(list, length, sizeof(ScoredItem), compare_postings);
+    }
+}
+
+// Matris ve türler yüklendikten sonra bir kez: tüm kullanıcıların tür sayıları ve türlerin sıralı film listeleri
+static void build_genre_tables(void) {
+    build_user_genre_counts();
+
+    for (int g = 0; g <= MAX_GENRES; g++) {
+        genre_offsets[g] = 0;
+    }
+    for (int i = 0; i < num_movies; i++) {
+        for (unsigned int mask = movie_genres[i]; mask != 0; mask &= mask - 1) {
+            genre_offsets[__builtin_ctz(mask) + 1]++;
+        }
+    }
+    for (int g = 0; g < MAX_GENRES; g++) {
+        genre_offsets[g + 1] += genre_offsets[g];
+    }
+    int fill[MAX_GENRES];
+    for (int g = 0; g < MAX_GENRES; g++) {
+        fill[g] = genre_offsets[g];
+    }
+    free(genre_postings);
+    genre_postings = malloc((genre_offsets[MAX_GENRES] + 1) * sizeof(ScoredItem));
+    for (int i = 0; i < num_movies; i++) {
+        for (unsigned int mask = movie_genres[i]; mask != 0; mask &= mask - 1) {
+            genre_postings[fill[__builtin_ctz(mask)]++].id = i;
+        }
+    }
+    refresh_genre_postings((1u << MAX_GENRES) - 1);
+}
+
+// kullanıcının en çok izlediği türden izlemediği filmleri öerir
+// Önerilen filmler (1 tabanlı id) out_movies, ortalama puanları out_ratings dizisine yazılır, öneri sayısı döner
+int recommend_movies(int user_id, int favorite_genre, int recommend_count, int *out_movies, double *out_ratings) { // öneri yapılacak kullanıcı, o kullanıcının favori türü ve kaç öneri yapılacağı alınır
+    METRICS_BEGIN(PHASE_GENRE);
+    // Türün listesi zaten puana göre sıralı: baştan yürüyüp izlenenler atlanır, recommend_count film bulununca durulur.
+    // Tüm katalog taranmaz, sorgu başına recommend_count + atlanan film kadar iş yapılır
+    const ScoredItem *list = genre_postings + genre_offsets[favorite_genre];
+    int length = genre_offsets[favorite_genre + 1] - genre_offsets[favorite_genre];
+    int result = 0;
+    int count = 0;
+    for (; count < length && result < recommend_count; count++) {
+        if (!hasRated(bipartite_matrix, user_id, list[count].id)) {
+            out_movies[result] = list[count].id + 1;
+            out_ratings[result] = list[count].score;
+            result++;
+        }
+    }
+    METRICS_ADD(METRIC_CANDIDATES_SCORED, count);
+    METRICS_END(PHASE_GENRE);
+    return result;
+}
+
+// Rastgele Yürüyüş Fonksiyonu
+// Kullanıcının düğümünden başlayıp puanı yüksek kenarları daha sık seçerek yürür, her adımda
+// config->restart olasılıkla kullanıcıya geri döner. En sık uğranan ve izlenmemiş filmler önerilir.
+// visits grafiğin düğüm sayısı (num_users + num_movies) kadar yer, best en az recommend_count elemanlık çalışma alanı
+// (ikisi de iş parçacığı başına), önerilen filmler (1 tabanlı id) out dizisine yazılır, öneri sayısı döner
+int random_walk_recommendation(int user_id, const WalkConfig *config, int recommend_count, unsigned *visits,
+                               ScoredItem *best, int *out) {
+    METRICS_BEGIN(PHASE_WALK);
+    walkWithRestart(walk_table, user_id, config, visits);  // kullanıcı user_id, user_id numaralı düğüm
+
+    TopK topk;
+    topkInit(&topk, best, recommend_count);
+    for (int i = 0; i < num_movies; i++) {
+        unsigned count = visits[num_users + i];
+        if (count > 0 && !hasRated(bipartite_matrix, user_id, i)) {
+            topkPush(&topk, i, count);  // eşit ziyarette küçük id önce
+        }
+    }
+
+    int recommendations = topkFinish(&topk);
+    for (int i = 0; i < recommendations; i++) {
+        out[i] = best[i].id + 1;
+    }
+    METRICS_END(PHASE_WALK);
+    return recommendations;
+}
@@ -0,0 +1,42 @@
+#ifndef RECOMMEND2_H
+#define RECOMMEND2_H
+
+#include "bitmatrix.h"
+#include "graph.h"
+#include "snapshot.h"
+#include "topk.h"
+#include "walk.h"
+
+// oneri2'nin tür tabanlı önerisi ve rastgele yürüyüşü ile kullandıkları veri (puan matrisi, film türleri).
+// oneri2, sunucu ve diğer araçlar aynı kodu buradan kullanır.
+// Kullanıcı ve film sayıları yüklenen veriden bulunur; sadece tür sayısı u.item biçimi gereği sabittir.
+
+#define MAX_GENRES 19
+
+extern int num_users;
+extern int num_movies;
+extern RatingMatrix *bipartite_matrix;
+extern unsigned int *movie_genres;           //num_movies, film başına tür bit maskesi
+extern const char *genres[MAX_GENRES];
+extern WalkTable *walk_table;
+extern double bayes_prior;
+extern int (*user_genre_count)[MAX_GENRES];  //num_users satır, yüklemede tüm kullanıcılar için doldurulur
+
+void count_user_genres(int user_id, int *counts);
+void find_favorite_genre(const int *counts, int *favorite_genre, int *max_count);
+void build_bipartite_matrix(const char *filename);
+void build_bipartite_matrix_from_set(const RatingSet *set);
+void build_movie_genres(const char *filename);
+void load_from_snapshot(const char *filename, const char *ratings_file, const char *items_file);
+void load_genres_from_snapshot(const Snapshot *source);
+void free_bipartite_matrix(void);
+void share_rating_data(RatingMatrix *matrix);
+void build_user_genre_counts(void);
+void add_user_genres(int user_id, int movie_id, int delta);
+void refresh_genre_postings(unsigned int genre_mask);
+double genre_score(int movie_id);  // recommend_movies'in sıraladığı puan (0 tabanlı film)
+int recommend_movies(int user_id, int favorite_genre, int recommend_count, int *out_movies, double *out_ratings);
+int random_walk_recommendation(int user_id, const WalkConfig *config, int recommend_count, unsigned *visits,
+                               ScoredItem *best, int *out);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef RNG_H
+#define RNG_H
+
+// Her iş parçacığının kendi rastgele sayı üreteci (srand/rand ortak global durum kullandığı için)
+// splitmix64: küçük, hızlı ve tohumdan bağımsız dağılımı iyi
+typedef struct Rng {
+    unsigned long long state;
+} Rng;
+
+static inline void rngSeed(Rng *rng, unsigned long long seed) {
+    rng->state = seed;
+}
+
+static inline unsigned long long rngNext(Rng *rng) {
+    unsigned long long z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// [0, n) aralığında sayı, rand() % n yerine
+static inline int rngRange(Rng *rng, int n) {
+    return (int)(((rngNext(rng) >> 32) * (unsigned long long)n) >> 32);
+}
+
+#endif
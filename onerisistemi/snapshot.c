@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "snapshot.h"
+
+#define SECTION_ALIGN 64
+
+// 64 bitlik kelimeler üzerinde FNV-1a benzeri sağlama toplamı (kalan baytlar tek tek eklenir)
+uint64_t checksumBytes(const unsigned char *data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        memcpy(&word, data + i * 8, 8);
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    for (size_t i = words * 8; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static void fileStamp(const char *path, int64_t *size, int64_t *mtime) {
+    struct stat info;
+    if (path != NULL && stat(path, &info) == 0) {
+        *size = (int64_t)info.st_size;
+        *mtime = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+    } else {
+        *size = -1;
+        *mtime = -1;
+    }
+}
+
+int writeSnapshot(const char *path, const char *ratingsFile, const char *itemsFile, long ratingCount,
+                  const RatingMatrix *matrix, const MovieGenres *genres, const ItemNeighbors *items) {
+    int users = matrix->users;
+    int movies = matrix->movies;
+    uint64_t nonZeros = (uint64_t)matrix->nonZeros;
+    if (matrix->rowLimits != NULL) {
+        printf("Snapshot sadece sikisik (dosyadan kurulmus) veriden yazilabilir: %s\n", path);
+        return -1;
+    }
+
+    // Bölümlerin kaynakları ve boyutları
+    const void *sources[SECTION_COUNT];
+    uint64_t sizes[SECTION_COUNT];
+    sources[SECTION_ROW_OFFSETS] = matrix->rowOffsets;
+    sizes[SECTION_ROW_OFFSETS] = (uint64_t)(users + 1) * sizeof(long);
+    sources[SECTION_ROW_MOVIES] = matrix->rowMovies;
+    sizes[SECTION_ROW_MOVIES] = nonZeros * sizeof(int);
+    sources[SECTION_ROW_RATINGS] = matrix->rowRatings;
+    sizes[SECTION_ROW_RATINGS] = nonZeros;
+    sources[SECTION_ROW_TIMES] = matrix->rowTimes;
+    sizes[SECTION_ROW_TIMES] = nonZeros * sizeof(unsigned int);
+    sources[SECTION_COL_OFFSETS] = matrix->colOffsets;
+    sizes[SECTION_COL_OFFSETS] = (uint64_t)(movies + 1) * sizeof(long);
+    sources[SECTION_COL_USERS] = matrix->colUsers;
+    sizes[SECTION_COL_USERS] = nonZeros * sizeof(int);
+    sources[SECTION_COL_RATINGS] = matrix->colRatings;
+    sizes[SECTION_COL_RATINGS] = nonZeros;
+    sources[SECTION_GENRES] = NULL;         //film sayısına göre kırpılır/tamamlanır
+    sizes[SECTION_GENRES] = (uint64_t)(movies + 1) * sizeof(unsigned int);
+    sources[SECTION_ITEM_IDS] = items->ids;
+    sizes[SECTION_ITEM_IDS] = (uint64_t)movies * items->neighbors * sizeof(int);
+    sources[SECTION_ITEM_SCORES] = items->scores;
+    sizes[SECTION_ITEM_SCORES] = (uint64_t)movies * items->neighbors * sizeof(float);
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.users = users;
+    header.movies = movies;
+    header.itemNeighbors = items->neighbors;
+    header.ratingCount = ratingCount;
+    header.matrixNonZeros = matrix->nonZeros;
+    fileStamp(ratingsFile, &header.ratingsFileSize, &header.ratingsFileMtime);
+    fileStamp(itemsFile, &header.itemsFileSize, &header.itemsFileMtime);
+
+    uint64_t offset = (sizeof(SnapshotHeader) + SECTION_ALIGN - 1) & ~(uint64_t)(SECTION_ALIGN - 1);
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        header.sectionOffset[i] = offset;
+        header.sectionSize[i] = sizes[i];
+        offset = (offset + sizes[i] + SECTION_ALIGN - 1) & ~(uint64_t)(SECTION_ALIGN - 1);
+    }
+    header.fileSize = offset;
+
+    // Dosya bellekte kurulur, sağlama toplamı hesaplanır ve tek seferde yazılır
+    unsigned char *image = (unsigned char *)calloc(1, header.fileSize);
+    if (image == NULL) {
+        printf("Snapshot icin bellek ayrilamadi.\n");
+        return -1;
+    }
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        if (sources[i] != NULL && sizes[i] > 0) {
+            memcpy(image + header.sectionOffset[i], sources[i], sizes[i]);
+        }
+    }
+    unsigned int *genreSection = (unsigned int *)(image + header.sectionOffset[SECTION_GENRES]);
+    for (int m = 0; m <= movies && m <= genres->maxMovie; m++) {
+        genreSection[m] = genres->genres[m];
+    }
+
+    size_t headerArea = header.sectionOffset[0];
+    header.checksum = checksumBytes(image + headerArea, header.fileSize - headerArea);
+    memcpy(image, &header, sizeof(header));
+
+    // Yarım yazılmış bir dosya açılmasın diye önce geçici dosyaya yazılıp sonra adı değiştirilir
+    char tempPath[4096];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL) {
+        printf("Snapshot dosyasi acilamadi: %s\n", tempPath);
+        free(image);
+        return -1;
+    }
+    size_t written = fwrite(image, 1, header.fileSize, file);
+    int closed = fclose(file);
+    free(image);
+    if (written != header.fileSize || closed != 0 || rename(tempPath, path) != 0) {
+        printf("Snapshot yazilamadi: %s\n", path);
+        remove(tempPath);
+        return -1;
+    }
+    return 0;
+}
+
+static int sectionFits(const SnapshotHeader *header, int section, uint64_t expected) {
+    return header->sectionSize[section] == expected &&
+           header->sectionOffset[section] % SECTION_ALIGN == 0 &&
+           header->sectionOffset[section] + expected <= header->fileSize;
+}
+
+int openSnapshot(const char *path, const char *ratingsFile, const char *itemsFile, Snapshot *snapshot) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Snapshot dosyasi acilamadi: %s\n", path);
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader)) {
+        printf("Snapshot dosyasi gecersiz: %s\n", path);
+        close(fd);
+        return -1;
+    }
+    void *base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("Snapshot dosyasi eslenemedi: %s\n", path);
+        return -1;
+    }
+
+    const SnapshotHeader *header = (const SnapshotHeader *)base;
+    const char *error = NULL;
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, 8) != 0) {
+        error = "snapshot dosyasi degil";
+    } else if (header->version != SNAPSHOT_VERSION) {
+        error = "surum uyusmuyor";
+    } else if (header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+        error = "bayt sirasi uyusmuyor";
+    } else if (header->fileSize != (uint64_t)info.st_size) {
+        error = "dosya boyutu uyusmuyor";
+    }
+
+    if (error == NULL) {
+        uint64_t nonZeros = (uint64_t)header->matrixNonZeros;
+        uint64_t itemCells = (uint64_t)header->movies * (uint64_t)header->itemNeighbors;
+        if (header->users <= 0 || header->movies <= 0 || header->itemNeighbors < 0 ||
+            header->matrixNonZeros < 0 || header->matrixNonZeros > header->ratingCount ||
+            !sectionFits(header, SECTION_ROW_OFFSETS, (uint64_t)(header->users + 1) * sizeof(long)) ||
+            !sectionFits(header, SECTION_ROW_MOVIES, nonZeros * sizeof(int)) ||
+            !sectionFits(header, SECTION_ROW_RATINGS, nonZeros) ||
+            !sectionFits(header, SECTION_ROW_TIMES, nonZeros * sizeof(unsigned int)) ||
+            !sectionFits(header, SECTION_COL_OFFSETS, (uint64_t)(header->movies + 1) * sizeof(long)) ||
+            !sectionFits(header, SECTION_COL_USERS, nonZeros * sizeof(int)) ||
+            !sectionFits(header, SECTION_COL_RATINGS, nonZeros) ||
+            !sectionFits(header, SECTION_GENRES, (uint64_t)(header->movies + 1) * sizeof(unsigned int)) ||
+            !sectionFits(header, SECTION_ITEM_IDS, itemCells * sizeof(int)) ||
+            !sectionFits(header, SECTION_ITEM_SCORES, itemCells * sizeof(float))) {
+            error = "bolum tablosu gecersiz";
+        }
+    }
+
+    if (error == NULL) {
+        int64_t size, mtime;
+        fileStamp(ratingsFile, &size, &mtime);
+        if (size >= 0 && (size != header->ratingsFileSize || mtime != header->ratingsFileMtime)) {
+            error = "snapshot eski, puan dosyasi sonradan degismis";
+        }
+        fileStamp(itemsFile, &size, &mtime);
+        if (error == NULL && size >= 0 && (size != header->itemsFileSize || mtime != header->itemsFileMtime)) {
+            error = "snapshot eski, film dosyasi sonradan degismis";
+        }
+    }
+
+    if (error == NULL) {
+        size_t headerArea = header->sectionOffset[0];
+        if (checksumBytes((const unsigned char *)base + headerArea, header->fileSize - headerArea) != header->checksum) {
+            error = "saglama toplami tutmuyor";
+        }
+    }
+
+    if (error != NULL) {
+        printf("Snapshot reddedildi (%s): %s\n", error, path);
+        munmap(base, (size_t)info.st_size);
+        return -1;
+    }
+
+    const char *bytes = (const char *)base;
+    snapshot->base = base;
+    snapshot->size = (size_t)info.st_size;
+    snapshot->header = header;
+    snapshot->users = header->users;
+    snapshot->movies = header->movies;
+
+    snapshot->matrix.users = header->users;
+    snapshot->matrix.movies = header->movies;
+    snapshot->matrix.nonZeros = header->matrixNonZeros;
+    snapshot->matrix.rowOffsets = (long *)(bytes + header->sectionOffset[SECTION_ROW_OFFSETS]);
+    snapshot->matrix.rowMovies = (int *)(bytes + header->sectionOffset[SECTION_ROW_MOVIES]);
+    snapshot->matrix.rowRatings = (unsigned char *)(bytes + header->sectionOffset[SECTION_ROW_RATINGS]);
+    snapshot->matrix.rowTimes = (unsigned int *)(bytes + header->sectionOffset[SECTION_ROW_TIMES]);
+    snapshot->matrix.colOffsets = (long *)(bytes + header->sectionOffset[SECTION_COL_OFFSETS]);
+    snapshot->matrix.colUsers = (int *)(bytes + header->sectionOffset[SECTION_COL_USERS]);
+    snapshot->matrix.colRatings = (unsigned char *)(bytes + header->sectionOffset[SECTION_COL_RATINGS]);
+    snapshot->matrix.rowEnds = snapshot->matrix.rowOffsets + 1;
+    snapshot->matrix.colEnds = snapshot->matrix.colOffsets + 1;
+    snapshot->matrix.rowLimits = NULL;
+    snapshot->matrix.colLimits = NULL;
+
+    snapshot->matrix.movieSum = (int *)malloc(header->movies * sizeof(int));
+    snapshot->matrix.movieCount = (int *)malloc(header->movies * sizeof(int));
+    rebuildMovieStats(&snapshot->matrix);
+    buildBitPlanes(&snapshot->matrix);
+
+    snapshot->genres = (const unsigned int *)(bytes + header->sectionOffset[SECTION_GENRES]);
+
+    snapshot->items.movies = header->movies;
+    snapshot->items.neighbors = header->itemNeighbors;
+    snapshot->items.ids = (const int *)(bytes + header->sectionOffset[SECTION_ITEM_IDS]);
+    snapshot->items.scores = (const float *)(bytes + header->sectionOffset[SECTION_ITEM_SCORES]);
+    snapshot->items.owned = 0;
+    return 0;
+}
+
+void closeSnapshot(Snapshot *snapshot) {
+    if (snapshot->base != NULL) {
+        munmap(snapshot->base, snapshot->size);
+        snapshot->base = NULL;
+        free(snapshot->matrix.movieSum);
+        free(snapshot->matrix.movieCount);
+        freeBitPlanes(&snapshot->matrix);
+    }
+}
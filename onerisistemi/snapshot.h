@@ -0,0 +1,83 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "loader.h"
+#include "bitmatrix.h"
+#include "itemsim.h"
+
+// Önceden kurulmuş veri yapılarının ikili (binary) anlık görüntüsü (snapshot).
+// derle aracı u.data ve u.item'dan tüm yapıları bir kez kurup dosyaya yazar; oneri1 ve oneri2
+// bu dosyayı salt okunur mmap ile açar, metin ayrıştırmadan ve puan deposunu kurmadan doğrudan kullanır.
+// Aynı makinedeki süreçler dosyanın sayfa önbelleğindeki (page cache) tek kopyasını paylaşır.
+//
+// Dosya düzeni: SnapshotHeader, ardından 64 bayta hizalı bölümler. Başlıkta boyutlar, bölümlerin
+// yerleri, kaynak dosyaların boyut/değişiklik zamanı ve bölümlerin sağlama toplamı (checksum) vardır.
+
+#define SNAPSHOT_MAGIC "ONERISNP"
+#define SNAPSHOT_VERSION 5
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+typedef enum SnapshotSection {
+    SECTION_ROW_OFFSETS,    //long, users + 1 (matrisin kullanıcı satırları)
+    SECTION_ROW_MOVIES,     //int, matrixNonZeros
+    SECTION_ROW_RATINGS,    //unsigned char, matrixNonZeros
+    SECTION_ROW_TIMES,      //unsigned int, matrixNonZeros
+    SECTION_COL_OFFSETS,    //long, movies + 1 (film sıralı kopya)
+    SECTION_COL_USERS,      //int, matrixNonZeros
+    SECTION_COL_RATINGS,    //unsigned char, matrixNonZeros
+    SECTION_GENRES,         //unsigned int, movies + 1 (tür bit maskeleri)
+    SECTION_ITEM_IDS,       //int, movies * itemNeighbors (film-film komşuları, bkz. itemsim.h)
+    SECTION_ITEM_SCORES,    //float, movies * itemNeighbors
+    SECTION_COUNT
+} SnapshotSection;
+
+typedef struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    int32_t users;
+    int32_t movies;
+    int32_t itemNeighbors;     //film başına komşu sayısı
+    int64_t ratingCount;       //u.data'daki satır sayısı (tekrarlar dahil)
+    int64_t matrixNonZeros;    //tekrarlar ayıklandıktan sonra matristeki puan sayısı
+    int64_t ratingsFileSize;   //snapshot kurulurken u.data'nın boyutu ve değişiklik zamanı (ns)
+    int64_t ratingsFileMtime;
+    int64_t itemsFileSize;
+    int64_t itemsFileMtime;
+    uint64_t sectionOffset[SECTION_COUNT];
+    uint64_t sectionSize[SECTION_COUNT];
+    uint64_t fileSize;
+    uint64_t checksum;         //başlıktan sonraki tüm baytların sağlama toplamı
+} SnapshotHeader;
+
+// Açılmış bir snapshot. Diziler eşlenmiş dosyanın içini gösterir, serbest bırakılmamalıdır.
+// Sadece film istatistikleri (matrix.movieSum / movieCount) ve sığıyorsa bit düzlemleri açılırken
+// satır/sütunlardan kurulup ayrıca ayrılır, closeSnapshot bunları da bırakır.
+typedef struct Snapshot {
+    void *base;
+    size_t size;
+    const SnapshotHeader *header;
+    int users;
+    int movies;
+    RatingMatrix matrix;
+    const unsigned int *genres;
+    ItemNeighbors items;
+} Snapshot;
+
+// 64 bitlik kelimeler üzerinde FNV-1a benzeri sağlama toplamı (faktör modeli dosyası da bunu kullanır)
+uint64_t checksumBytes(const unsigned char *data, size_t size);
+
+// Başarılıysa 0, hata olursa -1 döner ve hata mesajı yazılır
+// ratingCount u.data'daki satır sayısı, sadece bilgi için başlığa yazılır
+int writeSnapshot(const char *path, const char *ratingsFile, const char *itemsFile, long ratingCount,
+                  const RatingMatrix *matrix, const MovieGenres *genres, const ItemNeighbors *items);
+
+// ratingsFile/itemsFile verilirse ve diskte varsa, snapshot'tan sonra değişmiş olmaları durumunda
+// snapshot eski sayılır ve reddedilir.
+int openSnapshot(const char *path, const char *ratingsFile, const char *itemsFile, Snapshot *snapshot);
+void closeSnapshot(Snapshot *snapshot);
+
+#endif
@@ -0,0 +1,956 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "batch.h"
+#include "recommend1.h"
+#include "recommend2.h"
+#include "ingest.h"
+#include "cache.h"
+#include "metrics.h"
+
+// Sürekli çalışan öneri sunucusu: veri bir kez yüklenir, istekler Unix soketinden gelir.
+// Kullanım: ./sunucu [-f puanlar] [-i filmler] [-S veri.snap] [-F] [-L bant[xsatir]] [-M model.mf] [-T gun] [-C MB] [-u oneri.sock] [-t thread] [-s tohum] [-w adim] [-r olasilik] [-p agirlik]
+//
+// Her istek bir satırdır:   algoritma kullanici oneri_sayisi
+//   algoritma: random, high_degree, similar_user, nearest, item, genre, walk, mf, trending
+// Cevap toplu moddaki satırın aynısıdır:   kullanici <TAB> algoritma <TAB> film1,film2,...
+// -L verilirse similar_user benzer kullanıcıyı MinHash/LSH ile yaklaşık bulur (bkz. minhash.h).
+// mf sadece -M ile egit'in yazdığı model açılınca vardır (bkz. mf.h), yoksa "ERR model yok" döner.
+// trending sadece -T ile (yarı ömür, gün) trend dizini kurulunca vardır (bkz. trend.h), yoksa "ERR trend yok" döner.
+// trending isteğine iki ek alan verilebilir (önbelleğe alınmaz):
+//   trending kullanici oneri_sayisi T        T anına göre çürümüş popülerlik (zaman damgası, saniye)
+//   trending kullanici oneri_sayisi t0 t1    [t0, t1] aralığında en çok puan alanlar
+// "add" ile gelen puanlar isteğin geldiği anın zaman damgasıyla eklenir.
+// Hatalı istekte "ERR mesaj" satırı döner. Bir bağlantıdan art arda istek gönderilebilir.
+// İşçiler bağlantıya değil isteğe bağlanır: dağıtıcı (serverDispatcher) bağlantıları poll ile izler, verisi gelen
+// bağlantı kuyruğa girer, bir işçi o an gelmiş satırları cevaplayıp bağlantıyı geri verir. Açık ama boşta bekleyen
+// istemciler işçi tutmaz; SERVER_IDLE_SECONDS boyunca istek göndermeyen bağlantılar kapatılır.
+// "metrics" isteği o ana kadarki evre sürelerini ve sayaçları tek satırlık JSON olarak döner
+// (sunucu -DONERI_METRICS ile derlenmediyse ERR).
+//
+// -F ile canlı mod: puan dosyası izlenir, sonuna eklenen satırlar yeniden yükleme olmadan hemen işlenir
+// (bkz. ingest.h). Ayrıca "add kullanici film puan" isteği puanı doğrudan ekler ya da değiştirir
+// ("OK eklendi" / "OK degisti" / "OK ayni" döner; dosyaya yazılmaz) ve "ingest" isteği o ana kadar
+// işlenen puanların sayılarını döner. Sorgular her zaman güncellemelerin tutarlı bir halini görür.
+// Rastgelelik kullanan yöntemler tohum ve kullanıcıdan türetilen üreteçle çalışır, aynı istek hep aynı cevabı alır.
+//
+// Bu yüzden cevaplar (kullanıcı, algoritma, öneri sayısı) anahtarıyla önbellekte tutulur (bkz. cache.h), -C ile
+// bellek sınırı MB olarak verilir (varsayılan 64, 0 ise kapalı). "cache" isteği isabet/kayıp sayılarını döner.
+// Canlı modda her grup sonunda sadece değişen puanlardan etkilenebilecek cevaplar atılır (bkz. invalidateResults).
+
+#define SERVER_BACKLOG 64
+#define SERVER_IDLE_SECONDS 300  //bu kadar süre istek göndermeyen bağlantı kapatılır
+#define SERVER_SEND_SECONDS 10   //cevabı bu kadar süre okunmayan bağlantı kesilir
+#define REQUEST_LINE_MAX 256
+#define REQUEST_BUFFER (16 * REQUEST_LINE_MAX)
+#define CACHE_DEFAULT_MB 64
+#define NEAREST_DEPS_MAX 2048  //nearest cevabının bağlı olduğu düğüm sayısı bundan fazlaysa her değişiklikte atılır
+
+enum {
+    A_RANDOM, A_HIGH_DEGREE, A_SIMILAR_USER, A_NEAREST, A_ITEM, A_MF, A_GENRE, A_WALK, A_TRENDING, A_COUNT
+};
+
+static const char *algorithmNames[A_COUNT] = {
+    "random", "high_degree", "similar_user", "nearest", "item", "mf", "genre", "walk", "trending"
+};
+
+// Bir gruptaki değişikliklerden önbellek için çıkarılanlar (grup sonunda yazma kilidi altında kurulup silinir)
+typedef struct Invalidation {
+    unsigned char *changed;     //grafik düğümü başına: bu grupta kenarı değişti
+    unsigned char *cowatchers;  //kullanıcı başına (1 tabanlı): değişen bir filmi izlemiş
+    ScoredItem *degreeMovies;   //değişen filmler (0 tabanlı), yeni derecelerine göre azalan
+    int degreeCount;
+    ScoredItem *genreMovies;    //değişen filmler türlerine göre gruplu, her grup yeni puana göre azalan
+    int genreOffsets[MAX_GENRES + 1];
+} Invalidation;
+
+// Bir istemci bağlantısı ve henüz tamamlanmamış istek satırı
+typedef struct Connection {
+    int fd;
+    int length;                  //data içindeki okunmuş ama cevaplanmamış bayt
+    time_t lastActive;           //son veri geldiği an
+    struct Connection *next;     //kuyruk bağlantısı
+    char data[REQUEST_BUFFER];
+} Connection;
+
+typedef struct ServerContext {
+    long steps;              //walk için toplam adım
+    double restart;
+    unsigned long long seed;
+    int listenFd;
+    volatile int stopping;
+    ResultCache *cache;      //-C 0 ise NULL
+    Invalidation invalidation;
+    pthread_mutex_t queueLock;
+    pthread_cond_t queueReady;
+    Connection *readyHead;   //verisi gelmiş, bir işçinin almasını bekleyen bağlantılar
+    Connection *readyTail;
+    Connection *returned;    //işçilerin bitirip dağıtıcıya geri verdikleri
+    int wakeFds[2];          //returned dolunca ya da kapanışta dağıtıcıyı poll'dan uyandıran boru
+} ServerContext;
+
+// Her iş parçacığının kendi çalışma alanı; işçi bir bağlantının o an gelmiş isteklerini cevaplayıp bırakır
+typedef struct ServerWorker {
+    ServerContext *context;
+    DijkstraScratch *scratch;
+    ItemScratch *items;
+    MinHashScratch *similar; //sadece -L ile
+    FactorScratch *factors;  //sadece -M ile
+    ScoredItem *best;        //numMovies elemanlı, en iyi k seçimi için (high_degree, walk, trending)
+    unsigned *visits;
+    int *movies;             //numMovies elemanlı cevap dizileri
+    double *ratings;
+    int *deps;               //önbelleğe verilecek bağımlılıklar (düğüm sayısı kadar)
+} ServerWorker;
+
+static unsigned long long userSeed(const ServerContext *context, int user) {
+    return context->seed ^ (0x9E3779B97F4A7C15ULL * (unsigned long long)user);
+}
+
+// Bir isteği çalıştırıp önerileri worker->movies'e yazar, öneri sayısını count'a koyar. mf istenip model yoksa -2,
+// trending istenip trend dizini yoksa -3 döner. trend sadece trending'in ek alanlı biçiminde verilir, yoksa NULL.
+// deps'e cevabın önbellekte hangi değişikliklerle geçersiz olacağı yazılır (kullanıcının kendi puanları hep dahil):
+//   high_degree:  threshold son önerinin derecesi (rec'ten az öneri varsa -1)
+//   similar_user: items[0] benzer kullanıcı
+//   nearest:      threshold son önerinin mesafesi, items ondan yakın tüm düğümler
+//   genre:        items[0] favori tür, threshold son önerinin puanı (rec'ten az öneri varsa -sonsuz)
+//   trending:     threshold son önerinin trend skoru (rec'ten az öneri varsa -sonsuz)
+// random, item ve mf sadece kullanıcının kendi satırına bağlıdır; walk tüm grafiğe bağlıdır (global).
+static int answerRequest(ServerWorker *worker, int algorithm, int user, int rec, const TrendQuery *trend, int *count,
+                         CacheDeps *deps) {
+    ServerContext *context = worker->context;
+    int *movies = worker->movies;
+    Rng rng;
+    rngSeed(&rng, userSeed(context, user));
+    deps->items = worker->deps;
+    deps->count = 0;
+    deps->threshold = 0;
+    deps->global = 0;
+
+    switch (algorithm) {
+    case A_RANDOM:
+        *count = recommendRandom(user, rec, &rng, movies);
+        break;
+    case A_HIGH_DEGREE:
+        *count = recommendHighDegree(user, rec, worker->best, movies);
+        deps->threshold = *count == rec ? ratingMatrix->movieCount[movies[rec - 1] - 1] : -1;
+        break;
+    case A_SIMILAR_USER: {
+        int similarUser = worker->similar != NULL ? findSimilarUserApprox(user, worker->similar) : findMostSimilarUser(user);
+        *count = similarUser != -1 ? recommendFromSimilarUser(user, similarUser, rec, movies) : 0;
+        worker->deps[0] = similarUser;
+        deps->count = 1;
+        deps->global = similarUser == -1;
+        break;
+    }
+    case A_NEAREST: {
+        *count = recommendNearestMovies(user, rec, worker->scratch, movies);
+        // Mesafesi son önerininkinden küçük düğümlere giden en kısa yollar sadece yine bu düğümlerden geçer; uçlarından
+        // biri bu kümede olmayan bir kenarın değişmesi bu mesafeleri de en yakın filmleri de değiştiremez.
+        // Arama o mesafedeki katmanı bitirip durduğu için bu düğümlerin hepsi aramanın dokunduklarının içindedir.
+        const DijkstraScratch *scratch = worker->scratch;
+        int radius = *count == rec ? scratch->reachUnits[numUsers + movies[rec - 1] - 1] : INT_MAX;
+        for (int i = 0; i < scratch->touchedCount && !deps->global; i++) {
+            int v = scratch->touched[i];
+            if (scratch->reachUnits[v] < radius) {
+                if (deps->count == NEAREST_DEPS_MAX) {
+                    deps->global = 1;
+                } else {
+                    worker->deps[deps->count++] = v;
+                }
+            }
+        }
+        deps->threshold = radius;
+        break;
+    }
+    case A_ITEM:
+        *count = recommendSimilarItems(itemNeighbors, ratingMatrix, user, rec, worker->items, movies);
+        break;
+    case A_MF:
+        if (worker->factors == NULL) {
+            return -2;
+        }
+        *count = recommendFactors(factorModel, ratingMatrix, user, rec, worker->factors, movies);
+        break;
+    case A_GENRE: {
+        int favoriteGenre, maxCount;
+        find_favorite_genre(user_genre_count[user - 1], &favoriteGenre, &maxCount);  //canlı modda yerinde güncel tutuluyor
+        *count = favoriteGenre != -1 ? recommend_movies(user - 1, favoriteGenre, rec, movies, worker->ratings) : 0;
+        worker->deps[0] = favoriteGenre;
+        deps->count = 1;
+        deps->threshold = *count == rec ? worker->ratings[rec - 1] : -DBL_MAX;
+        deps->global = favoriteGenre == -1 || bayes_prior > 0;  //Bayes ortalaması genel ortalamaya, o da her puana bağlı
+        break;
+    }
+    case A_WALK: {
+        WalkConfig walk = {context->steps, context->restart, 1, userSeed(context, user)};
+        *count = random_walk_recommendation(user - 1, &walk, rec, worker->visits, worker->best, movies);
+        deps->global = 1;
+        break;
+    }
+    case A_TRENDING:
+        if (trendIndex == NULL) {
+            return -3;
+        }
+        *count = recommendTrending(trendIndex, ratingMatrix, user, rec, trend, worker->best, movies);
+        deps->threshold = *count == rec ? trendIndex->score[movies[rec - 1] - 1] : -DBL_MAX;
+        break;
+    }
+    return 0;
+}
+
+static int findAlgorithm(const char *name) {
+    for (int a = 0; a < A_COUNT; a++) {
+        if (strcmp(name, algorithmNames[a]) == 0) {
+            return a;
+        }
+    }
+    return -1;
+}
+
+// Önbellek girdisinin algoritmasına göre bu gruptaki değişikliklerden etkilenip etkilenmediği
+// (kullanıcının kendi puanı değiştiyse girdileri zaten cacheDropUser ile atılmıştır)
+static int resultAffected(const CacheEntry *entry, void *ctx) {
+    const Invalidation *changes = (const Invalidation *)ctx;
+    const int *movies = entry->data;
+    const int *deps = entry->data + entry->count;
+    int user = entry->user;
+
+    switch (entry->algorithm) {
+    case A_HIGH_DEGREE:
+        // Dereceler sadece artar: izlenmemiş değişen bir film son önerinin derecesine yetiştiyse listeye girer
+        // (listedeyse de derecesi eşiği geçmiştir, sırası değişebilir)
+        for (int i = 0; i < changes->degreeCount && changes->degreeMovies[i].score >= entry->threshold; i++) {
+            if (!hasRated(ratingMatrix, user - 1, changes->degreeMovies[i].id)) {
+                return 1;
+            }
+        }
+        return 0;
+    case A_SIMILAR_USER:
+        // Benzer kullanıcının puanları değiştiyse öneriler, bu kullanıcının izlediği bir filme yeni puan geldiyse
+        // ortak film sayıları (ve benzer kullanıcı) değişebilir. LSH'de imzalar değişince adaylar da değişir.
+        return changes->changed[deps[0] - 1] || changes->cowatchers[user] || (userIndex != NULL && changes->degreeCount > 0);
+    case A_NEAREST:
+        for (int i = 0; i < entry->depCount; i++) {
+            if (changes->changed[deps[i]]) {
+                return 1;
+            }
+        }
+        return 0;
+    case A_GENRE: {
+        // Önerilen bir filmin ortalaması değiştiyse sıra bozulur; favori türde izlenmemiş bir filmin
+        // yeni ortalaması son önerininkine yetiştiyse listeye girer
+        for (int i = 0; i < entry->count; i++) {
+            if (changes->changed[numUsers + movies[i] - 1]) {
+                return 1;
+            }
+        }
+        int genre = deps[0];
+        for (int i = changes->genreOffsets[genre];
+             i < changes->genreOffsets[genre + 1] && changes->genreMovies[i].score >= entry->threshold; i++) {
+            if (!hasRated(ratingMatrix, user - 1, changes->genreMovies[i].id)) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+    case A_TRENDING:
+        // Skorlar her yeni puanla değişir: önerilen bir filmin skoru değiştiyse sıra bozulabilir, izlenmemiş
+        // değişen bir filmin skoru son önerininkine yetiştiyse listeye girer
+        for (int i = 0; i < entry->count; i++) {
+            if (changes->changed[numUsers + movies[i] - 1]) {
+                return 1;
+            }
+        }
+        for (int i = 0; i < changes->degreeCount; i++) {
+            int movie = changes->degreeMovies[i].id;
+            if (trendIndex->score[movie] >= entry->threshold && !hasRated(ratingMatrix, user - 1, movie)) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+    return 0;
+}
+
+// ingest'in grup sonu çağrısı (yazma kilidi tutulurken): puanı değişen kullanıcıların tüm cevapları,
+// diğer kullanıcıların da sadece bu değişikliklerden etkilenebilecek cevapları önbellekten atılır
+static void invalidateResults(const int *vertices, const unsigned char *kinds, int count, void *ctx) {
+    ServerContext *context = (ServerContext *)ctx;
+    Invalidation *changes = &context->invalidation;
+    (void)kinds;  //puan değişmesi de (yeni puan gibi) ortalamayı, mesafeleri ve benzer kullanıcının önerilerini değiştirir
+
+    changes->degreeCount = 0;
+    for (int g = 0; g <= MAX_GENRES; g++) {
+        changes->genreOffsets[g] = 0;
+    }
+    for (int i = 0; i < count; i++) {
+        int v = vertices[i];
+        changes->changed[v] = 1;
+        if (v < numUsers) {
+            cacheDropUser(context->cache, v + 1);
+            continue;
+        }
+        int movie = v - numUsers;
+        changes->degreeMovies[changes->degreeCount].id = movie;
+        changes->degreeMovies[changes->degreeCount++].score = ratingMatrix->movieCount[movie];
+        for (unsigned int mask = movie_genres[movie]; mask != 0; mask &= mask - 1) {
+            changes->genreOffsets[__builtin_ctz(mask) + 1]++;
+        }
+        int raterCount;
+        const int *raters = movieColumn(ratingMatrix, movie, &raterCount);
+        for (int j = 0; j < raterCount; j++) {
+            changes->cowatchers[raters[j] + 1] = 1;
+        }
+    }
+    selectTopK(changes->degreeMovies, changes->degreeCount, changes->degreeCount);
+
+    int fill[MAX_GENRES];
+    for (int g = 0; g < MAX_GENRES; g++) {
+        changes->genreOffsets[g + 1] += changes->genreOffsets[g];
+        fill[g] = changes->genreOffsets[g];
+    }
+    for (int i = 0; i < changes->degreeCount; i++) {
+        int movie = changes->degreeMovies[i].id;
+        for (unsigned int mask = movie_genres[movie]; mask != 0; mask &= mask - 1) {
+            ScoredItem *item = &changes->genreMovies[fill[__builtin_ctz(mask)]++];
+            item->id = movie;
+            item->score = genre_score(movie);
+        }
+    }
+    for (int g = 0; g < MAX_GENRES; g++) {
+        int length = changes->genreOffsets[g + 1] - changes->genreOffsets[g];
+        selectTopK(changes->genreMovies + changes->genreOffsets[g], length, length);
+    }
+
+    cacheDropIf(context->cache, A_HIGH_DEGREE, resultAffected, changes);
+    cacheDropIf(context->cache, A_SIMILAR_USER, resultAffected, changes);
+    cacheDropIf(context->cache, A_NEAREST, resultAffected, changes);
+    cacheDropIf(context->cache, A_GENRE, resultAffected, changes);
+    cacheDropIf(context->cache, A_TRENDING, resultAffected, changes);
+    cacheDropIf(context->cache, A_WALK, NULL, NULL);
+
+    for (int i = 0; i < count; i++) {
+        int v = vertices[i];
+        changes->changed[v] = 0;
+        if (v >= numUsers) {
+            int raterCount;
+            const int *raters = movieColumn(ratingMatrix, v - numUsers, &raterCount);
+            for (int j = 0; j < raterCount; j++) {
+                changes->cowatchers[raters[j] + 1] = 0;
+            }
+        }
+    }
+}
+
+static void sendAll(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            shutdown(fd, SHUT_RDWR);  //istemci gitti ya da okumuyor (SO_SNDTIMEO): sonraki okuma bağlantıyı kapatır
+            return;
+        }
+        data += written;
+        len -= written;
+    }
+}
+
+static void sendText(int fd, const char *text) {
+    sendAll(fd, text, strlen(text));
+}
+
+// Tüm işçilerin ölçümlerini toplayıp tek satır olarak gönderir
+static void sendMetrics(int fd) {
+    if (!METRICS_ENABLED) {
+        sendText(fd, "ERR olcum kapali (-DONERI_METRICS ile derleyin)\n");
+        return;
+    }
+    char *text = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&text, &len);
+    if (out == NULL) {
+        sendText(fd, "ERR bellek yetersiz\n");
+        return;
+    }
+    MetricsSnapshot snapshot;
+    metricsCollect(&snapshot);
+    metricsWriteJson(out, &snapshot);
+    fputc('\n', out);
+    fclose(out);
+    sendAll(fd, text, len);
+    free(text);
+}
+
+// "add kullanici film puan": canlı modda puanı ekler ya da değiştirir
+static void addRating(int fd, const char *line) {
+    Rating rating = {0, 0, 0, 0};
+    if (sscanf(line, "add %d %d %d", &rating.user, &rating.movie, &rating.rating) != 3) {
+        sendText(fd, "ERR istek: add kullanici film puan\n");
+        return;
+    }
+    rating.timestamp = (unsigned int)time(NULL);
+    if (!ingestActive()) {
+        sendText(fd, "ERR canli mod kapali (-F ile baslatin)\n");
+        return;
+    }
+    IngestStats stats = {0, 0, 0, 0};
+    ingestRatings(&rating, 1, &stats);
+    if (stats.skipped > 0) {
+        sendText(fd, "ERR gecersiz kullanici, film ya da puan\n");
+    } else {
+        sendText(fd, stats.added > 0 ? "OK eklendi\n" : (stats.changed > 0 ? "OK degisti\n" : "OK ayni\n"));
+    }
+}
+
+static void sendCacheStats(int fd, ResultCache *cache) {
+    if (cache == NULL) {
+        sendText(fd, "ERR onbellek kapali (-C ile boyut verin)\n");
+        return;
+    }
+    CacheStats stats;
+    cacheGetStats(cache, &stats);
+    char text[256];
+    snprintf(text, sizeof(text), "isabet %ld kayip %ld eklenen %ld tasan %ld gecersiz %ld girdi %ld bellek %zu\n",
+             stats.hits, stats.misses, stats.inserts, stats.evictions, stats.invalidations, stats.entries, stats.bytes);
+    sendText(fd, text);
+}
+
+static void sendIngestTotals(int fd) {
+    if (!ingestActive()) {
+        sendText(fd, "ERR canli mod kapali (-F ile baslatin)\n");
+        return;
+    }
+    IngestStats stats;
+    ingestTotals(&stats);
+    char text[160];
+    snprintf(text, sizeof(text), "eklenen %ld degisen %ld ayni %ld atlanan %ld\n",
+             stats.added, stats.changed, stats.unchanged, stats.skipped);
+    sendText(fd, text);
+}
+
+// Tek bir istek satırını cevaplar
+static void serveLine(ServerWorker *worker, int fd, const char *line, BatchBuffer *out) {
+    char algorithm[32];
+    int user, rec;
+    unsigned int from, to;
+    out->len = 0;
+
+    if (strncmp(line, "metrics", 7) == 0 && (line[7] == '\n' || line[7] == '\r' || line[7] == '\0')) {
+        sendMetrics(fd);
+        return;
+    }
+    if (strncmp(line, "add ", 4) == 0) {
+        addRating(fd, line);
+        return;
+    }
+    if (strncmp(line, "ingest", 6) == 0 && (line[6] == '\n' || line[6] == '\r' || line[6] == '\0')) {
+        sendIngestTotals(fd);
+        return;
+    }
+    if (strncmp(line, "cache", 5) == 0 && (line[5] == '\n' || line[5] == '\r' || line[5] == '\0')) {
+        sendCacheStats(fd, worker->context->cache);
+        return;
+    }
+    int fields = sscanf(line, "%31s %d %d %u %u", algorithm, &user, &rec, &from, &to);
+    if (fields < 3) {
+        sendText(fd, "ERR istek: algoritma kullanici oneri_sayisi\n");
+        return;
+    }
+    for (char *c = algorithm; *c; c++) {
+        if (*c == '-') {
+            *c = '_';  //high-degree ve high_degree ikisi de kabul edilir
+        }
+    }
+    if (user < 1 || user > numUsers) {
+        sendText(fd, "ERR gecersiz kullanici\n");
+        return;
+    }
+    if (rec < 1 || rec > numMovies) {
+        sendText(fd, "ERR gecersiz oneri sayisi\n");
+        return;
+    }
+    int id = findAlgorithm(algorithm);
+    if (id < 0) {
+        sendText(fd, "ERR bilinmeyen algoritma\n");
+        return;
+    }
+    // trending'in ek alanları: tek alan çürümenin anı, iki alan puan sayısı penceresi (diğerlerinde yok sayılır)
+    TrendQuery query = {0, from, 1};
+    if (id == A_TRENDING && fields == 5) {
+        query.from = from;
+        query.to = to;
+        query.decay = 0;
+    }
+    const TrendQuery *trend = id == A_TRENDING && fields > 3 ? &query : NULL;
+
+    // Hesaplama ve önbelleğe ekleme aynı okuma kilidi içinde: araya giren bir grup eski cevabı geride bırakamaz
+    ResultCache *cache = trend == NULL ? worker->context->cache : NULL;
+    ingestReadLock();
+    int count = cache != NULL ? cacheLookup(cache, user, id, rec, worker->movies) : -1;
+    int status = 0;
+    if (count < 0) {
+        CacheDeps deps;
+        status = answerRequest(worker, id, user, rec, trend, &count, &deps);
+        if (status == 0 && cache != NULL) {
+            cacheInsert(cache, user, id, rec, worker->movies, count, &deps);
+        }
+    }
+    ingestReadUnlock();
+    if (status == -2) {
+        sendText(fd, "ERR model yok (-M ile baslatin)\n");
+        return;
+    }
+    if (status == -3) {
+        sendText(fd, "ERR trend yok (-T ile baslatin)\n");
+        return;
+    }
+    batchWriteList(out, user, algorithmNames[id], worker->movies, count);
+    sendAll(fd, out->data, out->len);
+}
+
+// Bağlantıdaki hazır veriyi okuyup içindeki tam satırları cevaplar. Okuma beklemez: veri bitince bağlantı
+// dağıtıcıya geri verilir, böylece boşta duran bir istemci işçiyi tutmaz. Bağlantı kapandıysa 0 döner.
+static int serveReady(ServerWorker *worker, Connection *connection, BatchBuffer *out) {
+    ssize_t received = recv(connection->fd, connection->data + connection->length,
+                            sizeof(connection->data) - connection->length, MSG_DONTWAIT);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return 1;  //poll hazır dedi ama veri başkası tarafından okunmuş ya da sinyal geldi
+    }
+    int closed = received <= 0;
+    if (!closed) {
+        connection->length += received;
+        connection->lastActive = time(NULL);
+    }
+
+    // fgets gibi: satır REQUEST_LINE_MAX - 1 karakteri geçerse o kadarı bir satır sayılır
+    char line[REQUEST_LINE_MAX];
+    int used = 0;
+    while (used < connection->length) {
+        int available = connection->length - used;
+        int limit = available < REQUEST_LINE_MAX - 1 ? available : REQUEST_LINE_MAX - 1;
+        const char *newline = memchr(connection->data + used, '\n', limit);
+        int length = newline != NULL ? (int)(newline - (connection->data + used)) + 1 : limit;
+        if (newline == NULL && limit < REQUEST_LINE_MAX - 1 && !closed) {
+            break;  //satırın devamı henüz gelmedi
+        }
+        memcpy(line, connection->data + used, length);
+        line[length] = '\0';
+        used += length;
+        serveLine(worker, connection->fd, line, out);
+    }
+    connection->length -= used;
+    memmove(connection->data, connection->data + used, connection->length);
+    return !closed;
+}
+
+static void closeConnection(Connection *connection) {
+    close(connection->fd);
+    free(connection);
+}
+
+// Okunacak verisi olan bir bağlantı gelene kadar bekler; kapanışta NULL döner
+static Connection *takeReady(ServerContext *context) {
+    pthread_mutex_lock(&context->queueLock);
+    while (context->readyHead == NULL && !context->stopping) {
+        pthread_cond_wait(&context->queueReady, &context->queueLock);
+    }
+    Connection *connection = NULL;
+    if (!context->stopping) {
+        connection = context->readyHead;
+        context->readyHead = connection->next;
+        if (context->readyHead == NULL) {
+            context->readyTail = NULL;
+        }
+    }
+    pthread_mutex_unlock(&context->queueLock);
+    return connection;
+}
+
+// İşçi bağlantıyla işini bitirdi: dağıtıcı onu yeniden poll'a ekler
+static void returnConnection(ServerContext *context, Connection *connection) {
+    pthread_mutex_lock(&context->queueLock);
+    connection->next = context->returned;
+    context->returned = connection;
+    pthread_mutex_unlock(&context->queueLock);
+    char wake = 1;
+    if (write(context->wakeFds[1], &wake, 1) < 0) {
+        //boru doluysa dağıtıcı zaten uyanacak
+    }
+}
+
+static void *serverWorker(void *arg) {
+    ServerWorker *worker = (ServerWorker *)arg;
+    ServerContext *context = worker->context;
+    BatchBuffer out = {NULL, 0, 0};
+
+    Connection *connection;
+    while ((connection = takeReady(context)) != NULL) {
+        if (serveReady(worker, connection, &out) && !context->stopping) {
+            returnConnection(context, connection);
+        } else {
+            closeConnection(connection);
+        }
+    }
+    free(out.data);
+    return NULL;
+}
+
+// Dağıtıcı: yeni bağlantıları kabul eder, boştaki bağlantıları poll ile izler ve verisi gelen bağlantıyı
+// işçilerin kuyruğuna koyar. Bir bağlantı aynı anda ya burada, ya kuyrukta ya da tek bir işçidedir.
+// SERVER_IDLE_SECONDS boyunca istek göndermeyen bağlantılar kapatılır.
+static void *serverDispatcher(void *arg) {
+    ServerContext *context = (ServerContext *)arg;
+    int capacity = 64;
+    int watchedCount = 0;
+    Connection **watched = (Connection **)malloc(capacity * sizeof(Connection *));
+    struct pollfd *polls = (struct pollfd *)malloc((capacity + 2) * sizeof(struct pollfd));
+
+    while (!context->stopping) {
+        // İşçilerin geri verdikleri yeniden izlenir
+        pthread_mutex_lock(&context->queueLock);
+        Connection *returned = context->returned;
+        context->returned = NULL;
+        pthread_mutex_unlock(&context->queueLock);
+        while (returned != NULL) {
+            Connection *next = returned->next;
+            if (watchedCount == capacity) {
+                capacity *= 2;
+                watched = (Connection **)realloc(watched, capacity * sizeof(Connection *));
+                polls = (struct pollfd *)realloc(polls, (capacity + 2) * sizeof(struct pollfd));
+            }
+            watched[watchedCount++] = returned;
+            returned = next;
+        }
+
+        polls[0].fd = context->listenFd;
+        polls[0].events = POLLIN;
+        polls[1].fd = context->wakeFds[0];
+        polls[1].events = POLLIN;
+        for (int i = 0; i < watchedCount; i++) {
+            polls[i + 2].fd = watched[i]->fd;
+            polls[i + 2].events = POLLIN;
+        }
+        if (poll(polls, watchedCount + 2, 1000) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (context->stopping) {
+            break;
+        }
+        if (polls[1].revents & POLLIN) {
+            char drain[64];
+            while (read(context->wakeFds[0], drain, sizeof(drain)) == (ssize_t)sizeof(drain)) {
+            }
+        }
+
+        // Verisi gelen (ya da kapanan) bağlantılar kuyruğa, uzun süre boşta kalanlar kapatılır
+        time_t now = time(NULL);
+        int kept = 0;
+        for (int i = 0; i < watchedCount; i++) {
+            Connection *connection = watched[i];
+            if (polls[i + 2].revents != 0) {
+                connection->next = NULL;
+                pthread_mutex_lock(&context->queueLock);
+                if (context->readyTail != NULL) {
+                    context->readyTail->next = connection;
+                } else {
+                    context->readyHead = connection;
+                }
+                context->readyTail = connection;
+                pthread_cond_signal(&context->queueReady);
+                pthread_mutex_unlock(&context->queueLock);
+            } else if (now - connection->lastActive > SERVER_IDLE_SECONDS) {
+                closeConnection(connection);
+            } else {
+                watched[kept++] = connection;
+            }
+        }
+        watchedCount = kept;
+
+        if (polls[0].revents & POLLIN) {
+            int fd = accept(context->listenFd, NULL, NULL);
+            if (fd >= 0) {
+                // Cevabı okumayan istemci işçiyi en fazla SERVER_SEND_SECONDS tutar, sonra bağlantısı kesilir
+                struct timeval timeout = {SERVER_SEND_SECONDS, 0};
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                Connection *connection = (Connection *)malloc(sizeof(Connection));
+                connection->fd = fd;
+                connection->length = 0;
+                connection->lastActive = now;
+                connection->next = NULL;
+                returnConnection(context, connection);  //bir sonraki turda izlenmeye başlar
+            }
+        }
+    }
+
+    for (int i = 0; i < watchedCount; i++) {
+        closeConnection(watched[i]);
+    }
+    free(watched);
+    free(polls);
+    return NULL;
+}
+
+static int openListenSocket(const char *path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        printf("Soket yolu cok uzun: %s\n", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        printf("Soket olusturulamadi\n");
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    unlink(path);  //önceki çalışmadan kalan soket dosyası
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SERVER_BACKLOG) != 0) {
+        printf("Sokete baglanilamadi: %s\n", path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void printUsage(const char *program) {
+    printf("Kullanim: %s [-f puanlar] [-i filmler] [-S veri.snap] [-F] [-L bant[xsatir]] [-M model.mf] [-T gun] [-C MB] [-u soket] [-t thread] [-s tohum] [-w adim] [-r olasilik] [-p agirlik]\n", program);
+}
+
+int main(int argc, char *argv[]) {
+    const char *snapshotFile = NULL;
+    const char *ratingsFile = "u.data";
+    const char *itemsFile = "u.item";
+    const char *socketPath = "oneri.sock";
+    int threads = 0;
+    int live = 0;
+    int lshBands = 0;
+    int lshRows = MINHASH_ROWS;
+    const char *modelFile = NULL;
+    double halfLifeDays = 0;
+    long cacheMegabytes = CACHE_DEFAULT_MB;
+    ServerContext context = {.steps = 20000, .restart = 0.15, .seed = (unsigned long long)time(NULL), .listenFd = -1};
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+            snapshotFile = argv[++i];
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            ratingsFile = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            itemsFile = argv[++i];
+        } else if (strcmp(argv[i], "-F") == 0) {
+            live = 1;
+        } else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) {
+            if (parseMinHashShape(argv[++i], &lshBands, &lshRows) != 0) {
+                printf("Gecersiz LSH boyutu: %s (ornek: 16 ya da 16x4)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+            modelFile = argv[++i];
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            halfLifeDays = atof(argv[++i]);
+            if (halfLifeDays <= 0) {
+                printf("Gecersiz yari omur: %s (gun)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-C") == 0 && i + 1 < argc) {
+            cacheMegabytes = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            context.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            context.steps = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            context.restart = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            bayes_prior = atof(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (context.restart < 0 || context.restart >= 1) {
+        printf("Yeniden baslama olasiligi 0 ile 1 arasinda olmali.\n");
+        return 1;
+    }
+    if (cacheMegabytes < 0) {
+        printf("Gecersiz onbellek boyutu.\n");
+        return 1;
+    }
+
+    // İzleme, yüklemeden önceki dosya boyundan başlar; arada eklenen satırlar iki kez okunursa da sonuç aynıdır
+    struct stat ratingsInfo;
+    long followOffset = stat(ratingsFile, &ratingsInfo) == 0 ? (long)ratingsInfo.st_size : 0;
+
+    // Puanlar bir kez yüklenir, iki programın yöntemleri de aynı depoyu kullanır
+    if (snapshotFile != NULL) {
+        const Snapshot *opened = loadFromSnapshot(snapshotFile, ratingsFile, itemsFile);
+        share_rating_data(ratingMatrix);
+        load_genres_from_snapshot(opened);
+    } else {
+        loadRatingStore(ratingsFile);
+        share_rating_data(ratingMatrix);
+        build_movie_genres(itemsFile);
+    }
+    // Canlı modda yeni puanlar dizine de işlenir, izleme başlamadan kurulmalı
+    if (lshBands > 0) {
+        userIndex = buildMinHashIndex(ratingMatrix, lshBands, lshRows, MINHASH_SEED, 0);
+    }
+    if (modelFile != NULL && (factorModel = loadFactorModel(modelFile, ratingMatrix)) == NULL) {
+        return 1;
+    }
+    if (halfLifeDays > 0) {
+        trendIndex = buildTrendIndex(ratingMatrix, halfLifeDays);
+    }
+
+    if (cacheMegabytes > 0) {
+        context.cache = createResultCache((size_t)cacheMegabytes << 20, numUsers);
+    }
+    if (live) {
+        ingestStart();
+        if (context.cache != NULL) {
+            Invalidation *changes = &context.invalidation;
+            long memberships = 0;
+            for (int m = 0; m < numMovies; m++) {
+                memberships += __builtin_popcount(movie_genres[m]);
+            }
+            changes->changed = (unsigned char *)calloc(numUsers + numMovies, 1);
+            changes->cowatchers = (unsigned char *)calloc(numUsers + 1, 1);
+            changes->degreeMovies = (ScoredItem *)malloc(numMovies * sizeof(ScoredItem));
+            changes->genreMovies = (ScoredItem *)malloc((memberships + 1) * sizeof(ScoredItem));
+            ingestSetListener(invalidateResults, &context);
+        }
+        if (ingestFollow(ratingsFile, followOffset) != 0) {
+            printf("Puan dosyasi izlenemiyor: %s\n", ratingsFile);
+            return 1;
+        }
+    }
+
+    context.listenFd = openListenSocket(socketPath);
+    if (context.listenFd < 0) {
+        return 1;
+    }
+    if (pipe(context.wakeFds) != 0) {
+        printf("Boru olusturulamadi\n");
+        return 1;
+    }
+    fcntl(context.wakeFds[0], F_SETFL, O_NONBLOCK);
+    fcntl(context.wakeFds[1], F_SETFL, O_NONBLOCK);
+    pthread_mutex_init(&context.queueLock, NULL);
+    pthread_cond_init(&context.queueReady, NULL);
+
+    // SIGINT/SIGTERM sadece ana iş parçacığında sigwait ile beklenir, işçiler bunlardan etkilenmez
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    signal(SIGPIPE, SIG_IGN);  //cevabı beklemeden kapanan istemci sunucuyu düşürmesin
+
+    if (threads <= 0) {
+        threads = defaultThreadCount();
+    }
+    ServerWorker *workers = (ServerWorker *)malloc(threads * sizeof(ServerWorker));
+    pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        workers[i].context = &context;
+        workers[i].scratch = createDijkstraScratch(ratingMatrix);
+        workers[i].items = createItemScratch(numMovies);
+        workers[i].similar = userIndex != NULL ? createMinHashScratch(numUsers) : NULL;
+        workers[i].factors = factorModel != NULL ? createFactorScratch(numMovies) : NULL;
+        workers[i].best = (ScoredItem *)malloc(numMovies * sizeof(ScoredItem));
+        workers[i].visits = (unsigned *)malloc((numUsers + numMovies) * sizeof(unsigned));
+        workers[i].movies = (int *)malloc(numMovies * sizeof(int));
+        workers[i].ratings = (double *)malloc(numMovies * sizeof(double));
+        workers[i].deps = (int *)malloc((NEAREST_DEPS_MAX + 1) * sizeof(int));
+        pthread_create(&ids[i], NULL, serverWorker, &workers[i]);
+    }
+    pthread_t dispatcher;
+    pthread_create(&dispatcher, NULL, serverDispatcher, &context);
+    printf("Sunucu hazir: %s (%d is parcacigi%s)\n", socketPath, threads, live ? ", canli mod" : "");
+    fflush(stdout);
+
+    int received;
+    sigwait(&signals, &received);
+
+    // Kapanış: yeni bağlantı alınmaz, işçiler ellerindeki istekleri bitirir, bekleyen bağlantılar kapatılır
+    pthread_mutex_lock(&context.queueLock);
+    context.stopping = 1;
+    pthread_cond_broadcast(&context.queueReady);
+    pthread_mutex_unlock(&context.queueLock);
+    char wake = 1;
+    if (write(context.wakeFds[1], &wake, 1) < 0) {
+        //boru doluysa dağıtıcı zaten uyanacak
+    }
+    pthread_join(dispatcher, NULL);
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+        freeDijkstraScratch(workers[i].scratch);
+        freeItemScratch(workers[i].items);
+        if (workers[i].similar != NULL) {
+            freeMinHashScratch(workers[i].similar);
+        }
+        if (workers[i].factors != NULL) {
+            freeFactorScratch(workers[i].factors);
+        }
+        free(workers[i].best);
+        free(workers[i].visits);
+        free(workers[i].movies);
+        free(workers[i].ratings);
+        free(workers[i].deps);
+    }
+    free(workers);
+    free(ids);
+    for (Connection *list = context.readyHead; list != NULL;) {
+        Connection *next = list->next;
+        closeConnection(list);
+        list = next;
+    }
+    for (Connection *list = context.returned; list != NULL;) {
+        Connection *next = list->next;
+        closeConnection(list);
+        list = next;
+    }
+    close(context.wakeFds[0]);
+    close(context.wakeFds[1]);
+    pthread_mutex_destroy(&context.queueLock);
+    pthread_cond_destroy(&context.queueReady);
+    close(context.listenFd);
+    unlink(socketPath);
+
+    ingestStop();
+    freeResultCache(context.cache);
+    free(context.invalidation.changed);
+    free(context.invalidation.cowatchers);
+    free(context.invalidation.degreeMovies);
+    free(context.invalidation.genreMovies);
+    free_bipartite_matrix();
+    freeRatingStore();
+    printf("Sunucu kapandi.\n");
+    return 0;
+}
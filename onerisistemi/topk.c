@@ -0,0 +1,140 @@
+#include "topk.h"
+
+static void swapItems(ScoredItem *a, ScoredItem *b) {
+    ScoredItem temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+// Kökte en kötü eleman olacak şekilde yığın düzeltmeleri
+static void siftUp(ScoredItem *heap, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!betterItem(heap[parent], heap[i])) {
+            break;
+        }
+        swapItems(&heap[parent], &heap[i]);
+        i = parent;
+    }
+}
+
+static void siftDown(ScoredItem *heap, int count, int i) {
+    for (;;) {
+        int worst = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < count && betterItem(heap[worst], heap[left])) {
+            worst = left;
+        }
+        if (right < count && betterItem(heap[worst], heap[right])) {
+            worst = right;
+        }
+        if (worst == i) {
+            break;
+        }
+        swapItems(&heap[i], &heap[worst]);
+        i = worst;
+    }
+}
+
+void topkInit(TopK *topk, ScoredItem *storage, int k) {
+    topk->items = storage;
+    topk->capacity = k;
+    topk->count = 0;
+}
+
+void topkPush(TopK *topk, int id, double score) {
+    ScoredItem item = {score, id};
+    if (topk->count < topk->capacity) {
+        topk->items[topk->count] = item;
+        siftUp(topk->items, topk->count++);
+    } else if (topk->capacity > 0 && betterItem(item, topk->items[0])) {
+        topk->items[0] = item;
+        siftDown(topk->items, topk->count, 0);
+    }
+}
+
+// Yığını yerinde sıralar (en kötüyü sona taşıyarak), items en iyiden başlayarak dizilir
+int topkFinish(TopK *topk) {
+    for (int end = topk->count - 1; end > 0; end--) {
+        swapItems(&topk->items[0], &topk->items[end]);
+        siftDown(topk->items, end, 0);
+    }
+    return topk->count;
+}
+
+// Dizinin ilk k elemanını yığın olarak kullanıp kalanları tek tek dener
+static int heapSelect(ScoredItem *items, int n, int k) {
+    TopK topk = {items, k, 0};
+    for (int i = 0; i < k; i++) {
+        siftUp(items, i);
+    }
+    topk.count = k;
+    for (int i = k; i < n; i++) {
+        if (betterItem(items[i], items[0])) {
+            swapItems(&items[0], &items[i]);
+            siftDown(items, k, 0);
+        }
+    }
+    return topkFinish(&topk);
+}
+
+// Üçün ortancası ile pivot seçip [low, high] aralığını böler, pivotun son yerini döner
+static int partition(ScoredItem *items, int low, int high) {
+    int mid = low + (high - low) / 2;
+    if (betterItem(items[mid], items[low])) swapItems(&items[mid], &items[low]);
+    if (betterItem(items[high], items[low])) swapItems(&items[high], &items[low]);
+    if (betterItem(items[high], items[mid])) swapItems(&items[high], &items[mid]);
+    swapItems(&items[mid], &items[high]);
+    ScoredItem pivot = items[high];
+
+    int store = low;
+    for (int i = low; i < high; i++) {
+        if (betterItem(items[i], pivot)) {
+            swapItems(&items[i], &items[store++]);
+        }
+    }
+    swapItems(&items[store], &items[high]);
+    return store;
+}
+
+// nth_element: en iyi k eleman dizinin başına gelir (kendi aralarında sırasız).
+// Bölmeleme çok derinleşirse (kötü pivotlar) kalan aralık yığınla seçilir.
+static void partitionSelect(ScoredItem *items, int n, int k) {
+    int low = 0;
+    int high = n - 1;
+    int depthLimit = 2;
+    for (int m = n; m > 1; m >>= 1) {
+        depthLimit += 2;
+    }
+    while (low < high) {
+        if (depthLimit-- == 0) {
+            heapSelect(items + low, high - low + 1, k - low);
+            return;
+        }
+        int p = partition(items, low, high);
+        if (p == k - 1 || p == k) {
+            return;
+        }
+        if (p < k) {
+            low = p + 1;
+        } else {
+            high = p - 1;
+        }
+    }
+}
+
+int selectTopK(ScoredItem *items, int n, int k) {
+    if (k > n) {
+        k = n;
+    }
+    if (k <= 0) {
+        return 0;
+    }
+    // k adayların küçük bir kısmıysa yığın O(n log k) ile en ucuzu, değilse önce ortalama O(n) bölmeleme yapılır
+    if (k < n / 16 || k == n) {
+        return heapSelect(items, n, k);
+    }
+    partitionSelect(items, n, k);
+    return heapSelect(items, k, k);
+}
@@ -0,0 +1,33 @@
+#ifndef TOPK_H
+#define TOPK_H
+
+// En iyi k elemanı seçme (top-K). Tüm öneri yöntemleri sıralamayı bununla yapar.
+// Yüksek puan daha iyidir, puanlar eşitse küçük id öne geçer; böylece sonuç girdi sırasından bağımsızdır.
+
+typedef struct ScoredItem {
+    double score;
+    int id;
+} ScoredItem;
+
+// Akış halinde gelen adaylar için k elemanlı yığın (heap). Kökte o ana kadarki en kötü eleman durur,
+// yeni aday ondan iyiyse yerine geçer: aday başına O(log k), toplam O(n log k).
+// Yer çağıran tarafından verilir (yığında bir dizi olabilir), malloc yapılmaz.
+typedef struct TopK {
+    ScoredItem *items;
+    int capacity; //k
+    int count;
+} TopK;
+
+static inline int betterItem(ScoredItem a, ScoredItem b) {
+    return a.score > b.score || (a.score == b.score && a.id < b.id);
+}
+
+void topkInit(TopK *topk, ScoredItem *storage, int k);
+void topkPush(TopK *topk, int id, double score);
+int topkFinish(TopK *topk);
+
+// Adaylar zaten bir dizideyse: en iyi k tanesini dizinin başına en iyiden başlayarak sıralı koyar,
+// seçilen eleman sayısını döner. k küçükse yığın, büyükse nth_element gibi bölmeleme kullanılır.
+int selectTopK(ScoredItem *items, int n, int k);
+
+#endif
@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "trend.h"
+#include "metrics.h"
+
+#define TREND_LN2 0.69314718055994530942
+
+// ln(2^(time / yarı ömür)); tüm yollar aynı ifadeyi kullanır, canlı güncellenen ve baştan kurulan toplamlar aynı çıkar
+static inline double timeWeight(const TrendIndex *index, unsigned int time) {
+    return (double)time * (TREND_LN2 / index->halfLife);
+}
+
+// ln(e^a + e^b)
+static inline double logAdd(double a, double b) {
+    if (a == -INFINITY) {
+        return b;
+    }
+    double high = a > b ? a : b;
+    double low = a > b ? b : a;
+    return high + log1p(exp(low - high));
+}
+
+static int compareTimes(const void *a, const void *b) {
+    unsigned int x = *(const unsigned int *)a;
+    unsigned int y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+// Satırın from'dan (satır içi değil dizideki yer) sonraki önek toplamlarını ve filmin skorunu yeniden hesaplar
+static void refreshMass(TrendIndex *index, int movie, long from) {
+    double mass = from > index->starts[movie] ? index->logMass[from - 1] : -INFINITY;
+    for (long i = from; i < index->ends[movie]; i++) {
+        mass = logAdd(mass, timeWeight(index, index->times[i]));
+        index->logMass[i] = mass;
+    }
+    index->score[movie] = mass;
+}
+
+typedef double (*TrendKey)(const TrendIndex *index, int movie);
+
+static double countKey(const TrendIndex *index, int movie) {
+    return (double)(index->ends[movie] - index->starts[movie]);
+}
+
+static double scoreKey(const TrendIndex *index, int movie) {
+    return index->score[movie];
+}
+
+static inline int ahead(double keyA, int a, double keyB, int b) {
+    return keyA > keyB || (keyA == keyB && a < b);
+}
+
+// Sıralamayı key'e göre kurar (topk.h ile aynı sıra: büyük önce, eşitte küçük id önce)
+static void sortOrder(const TrendIndex *index, int *order, TrendKey key) {
+    ScoredItem *items = (ScoredItem *)malloc(index->movies * sizeof(ScoredItem));
+    for (int m = 0; m < index->movies; m++) {
+        items[m].id = m;
+        items[m].score = key(index, m);
+    }
+    selectTopK(items, index->movies, index->movies);
+    for (int m = 0; m < index->movies; m++) {
+        order[m] = items[m].id;
+    }
+    free(items);
+}
+
+// movie'nin anahtarı oldKey'den değişti; eski yeri ikili aramayla bulunur, film yeni yerine kaydırılır
+// (sadece aradaki filmler kayar)
+static void reposition(const TrendIndex *index, int *order, TrendKey key, int movie, double oldKey) {
+    int low = 0, high = index->movies;
+    while (low < high) {
+        int mid = (low + high) >> 1;
+        int other = order[mid];
+        if (other != movie && ahead(key(index, other), other, oldKey, movie)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    int from = low;
+
+    // Yeni yer, film çıkarılmış dizide aranır
+    double newKey = key(index, movie);
+    low = 0;
+    high = index->movies - 1;
+    while (low < high) {
+        int mid = (low + high) >> 1;
+        int other = order[mid < from ? mid : mid + 1];
+        if (ahead(key(index, other), other, newKey, movie)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    int to = low;
+    if (to < from) {
+        memmove(order + to + 1, order + to, (from - to) * sizeof(int));
+    } else if (to > from) {
+        memmove(order + from, order + from + 1, (to - from) * sizeof(int));
+    }
+    order[to] = movie;
+}
+
+// Satırda ilk time'dan küçük olmayan (upper 1 ise time'dan büyük olan) zamanın yeri
+static long timeBound(const TrendIndex *index, int movie, unsigned int time, int upper) {
+    long low = index->starts[movie];
+    long high = index->ends[movie];
+    while (low < high) {
+        long mid = (low + high) >> 1;
+        if (index->times[mid] < time || (upper && index->times[mid] == time)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+TrendIndex *buildTrendIndex(const RatingMatrix *matrix, double halfLifeDays) {
+    int movies = matrix->movies;
+    TrendIndex *index = (TrendIndex *)calloc(1, sizeof(TrendIndex));
+    index->movies = movies;
+    index->halfLife = halfLifeDays * TREND_DAY_SECONDS;
+    index->starts = (long *)malloc(movies * sizeof(long));
+    index->ends = (long *)malloc(movies * sizeof(long));
+    index->limits = (long *)malloc(movies * sizeof(long));
+
+    // Canlı güncellemede satırın sonuna eklenebilsin diye her satırın sonunda boş yer bırakılır (bkz. bitmatrix.c)
+    long position = 0;
+    for (int m = 0; m < movies; m++) {
+        long length = matrix->movieCount[m];
+        index->starts[m] = position;
+        index->ends[m] = position;
+        position += length + length / 4 + 4;
+        index->limits[m] = position;
+    }
+    index->slotsUsed = position;
+    index->slotCount = position;
+    index->times = (unsigned int *)malloc(position * sizeof(unsigned int));
+    index->logMass = (double *)malloc(position * sizeof(double));
+
+    for (int u = 0; u < matrix->users; u++) {
+        for (long i = matrix->rowOffsets[u]; i < matrix->rowEnds[u]; i++) {
+            int movie = matrix->rowMovies[i];
+            unsigned int time = matrix->rowTimes[i];
+            index->times[index->ends[movie]++] = time;
+            if (time > index->lastTime) {
+                index->lastTime = time;
+            }
+        }
+    }
+
+    index->score = (double *)malloc(movies * sizeof(double));
+    for (int m = 0; m < movies; m++) {
+        qsort(index->times + index->starts[m], index->ends[m] - index->starts[m], sizeof(unsigned int), compareTimes);
+        refreshMass(index, m, index->starts[m]);
+    }
+    index->ranked = (int *)malloc(movies * sizeof(int));
+    index->byCount = (int *)malloc(movies * sizeof(int));
+    sortOrder(index, index->ranked, scoreKey);
+    sortOrder(index, index->byCount, countKey);
+    return index;
+}
+
+void freeTrendIndex(TrendIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    free(index->starts);
+    free(index->ends);
+    free(index->limits);
+    free(index->times);
+    free(index->logMass);
+    free(index->score);
+    free(index->ranked);
+    free(index->byCount);
+    free(index);
+}
+
+// Zamanı satırdaki yerine koyar (eşit zamanların sonuna); yer yoksa satır dizinin sonuna iki kat yerle taşınır
+static long insertTime(TrendIndex *index, int movie, unsigned int time) {
+    long start = index->starts[movie];
+    long length = index->ends[movie] - start;
+    if (index->ends[movie] == index->limits[movie]) {
+        long room = 2 * length + 4;
+        if (index->slotsUsed + room > index->slotCount) {
+            long capacity = index->slotCount * 2;
+            if (capacity < index->slotsUsed + room) {
+                capacity = index->slotsUsed + room;
+            }
+            index->times = (unsigned int *)realloc(index->times, capacity * sizeof(unsigned int));
+            index->logMass = (double *)realloc(index->logMass, capacity * sizeof(double));
+            index->slotCount = capacity;
+        }
+        long moved = index->slotsUsed;
+        memcpy(index->times + moved, index->times + start, length * sizeof(unsigned int));
+        memcpy(index->logMass + moved, index->logMass + start, length * sizeof(double));
+        index->slotsUsed += room;
+        index->starts[movie] = moved;
+        index->ends[movie] = moved + length;
+        index->limits[movie] = moved + room;
+    }
+
+    long at = timeBound(index, movie, time, 1);
+    long tail = index->ends[movie] - at;
+    memmove(index->times + at + 1, index->times + at, tail * sizeof(unsigned int));
+    memmove(index->logMass + at + 1, index->logMass + at, tail * sizeof(double));
+    index->times[at] = time;
+    index->ends[movie]++;
+    if (time > index->lastTime) {
+        index->lastTime = time;
+    }
+    return at;
+}
+
+void trendAddRating(TrendIndex *index, int movie, unsigned int time) {
+    double oldScore = index->score[movie];
+    long at = insertTime(index, movie, time);
+    refreshMass(index, movie, at);
+    reposition(index, index->byCount, countKey, movie, countKey(index, movie) - 1);
+    reposition(index, index->ranked, scoreKey, movie, oldScore);
+}
+
+void trendMoveRating(TrendIndex *index, int movie, unsigned int oldTime, unsigned int newTime) {
+    double oldScore = index->score[movie];
+    long removed = timeBound(index, movie, oldTime, 0);
+    if (removed == index->ends[movie] || index->times[removed] != oldTime) {
+        printf("Trend dizininde puan bulunamadi (film %d, zaman %u)\n", movie + 1, oldTime);
+        exit(1);
+    }
+    long tail = index->ends[movie] - removed - 1;
+    memmove(index->times + removed, index->times + removed + 1, tail * sizeof(unsigned int));
+    memmove(index->logMass + removed, index->logMass + removed + 1, tail * sizeof(double));
+    index->ends[movie]--;
+
+    long at = insertTime(index, movie, newTime);  //satır taşınmaz, az önce bir yer boşaldı
+    refreshMass(index, movie, at < removed ? at : removed);
+    reposition(index, index->ranked, scoreKey, movie, oldScore);
+}
+
+void trendWindow(const TrendIndex *index, int movie, unsigned int from, unsigned int to, long *first, long *last) {
+    *first = timeBound(index, movie, from, 0);
+    *last = timeBound(index, movie, to, 1);
+    if (*last < *first) {
+        *last = *first;  //from > to
+    }
+}
+
+int recommendTrending(const TrendIndex *index, const RatingMatrix *matrix, int user, int rec,
+                      const TrendQuery *query, ScoredItem *items, int *out) {
+    METRICS_BEGIN(PHASE_TRENDING);
+    int count = 0;
+    int visited = 0;
+    if (query == NULL) {
+        // Sıra zaten hazır: izlenenler atlanır, k film bulununca durulur
+        for (; visited < index->movies && count < rec; visited++) {
+            int movie = index->ranked[visited];
+            if (index->score[movie] == -INFINITY) {
+                break;  //kalan filmlerin hiç puanı yok
+            }
+            if (!hasRated(matrix, user - 1, movie)) {
+                out[count++] = movie + 1;
+            }
+        }
+    } else {
+        // Puan sayısına göre azalan sırada gezilir: pencerede en fazla n puan olabilir, ağırlıkları da en fazla
+        // 2^(to / h) olduğundan log ağırlık en fazla ln(n) + ln(2^(to / h)); sınır k. adaydan kötüyse gerisi de kötüdür
+        double edge = timeWeight(index, query->to);
+        TopK topk;
+        topkInit(&topk, items, rec);
+        for (; visited < index->movies; visited++) {
+            int movie = index->byCount[visited];
+            long ratings = index->ends[movie] - index->starts[movie];
+            if (ratings == 0) {
+                break;
+            }
+            double bound = query->decay ? log((double)ratings) + edge : (double)ratings;
+            if (topk.count == rec && bound < topk.items[0].score) {
+                break;
+            }
+            if (hasRated(matrix, user - 1, movie)) {
+                continue;
+            }
+            long first, last;
+            trendWindow(index, movie, query->from, query->to, &first, &last);
+            if (first == last) {
+                continue;
+            }
+            double score = (double)(last - first);
+            if (query->decay) {
+                double high = index->logMass[last - 1];
+                double low = first > index->starts[movie] ? index->logMass[first - 1] : -INFINITY;
+                score = low == -INFINITY ? high : high + log1p(-exp(low - high));
+                if (score == -INFINITY) {
+                    continue;  //pencerenin ağırlığı öncekilerin yanında hassasiyet altında kaldı
+                }
+            }
+            topkPush(&topk, movie + 1, score);
+        }
+        count = topkFinish(&topk);
+        for (int k = 0; k < count; k++) {
+            out[k] = items[k].id;
+        }
+    }
+    METRICS_ADD(METRIC_CANDIDATES_SCORED, visited);
+    METRICS_END(PHASE_TRENDING);
+    return count;
+}
@@ -0,0 +1,71 @@
+#ifndef TREND_H
+#define TREND_H
+
+#include "bitmatrix.h"
+#include "topk.h"
+
+// Zamana bağlı popülerlik ("trending"): puan deposunun zaman damgalarından (rowTimes) kurulur.
+// high_degree tüm zamanların puan sayısına bakar; burada bir filmin her puanı zamanıyla tutulur ve
+//   çürüyen ağırlık: puan, yarı ömür kadar eskidikçe ağırlığının yarısını kaybeder (2^(-(T - t) / yarı ömür))
+//   pencere sayısı: [from, to] aralığında verilen puan sayısı
+// ile filmler sıralanır.
+//
+// Her filmin puan zamanları artan sırada bir satırda durur (puan başına 4 bayt), yanında satırın önek
+// toplamları: logMass[i] = ln(2^(t_0 / h) + ... + 2^(t_i / h)) (8 bayt). Böylece bir filmin herhangi bir
+// pencereye düşen puan sayısı iki ikili aramayla, çürümüş ağırlığı da iki önek toplamının farkıyla bulunur.
+// Toplamlar logaritmik tutulduğu için 2^(t / h) büyüklüğü taşmaz; T'ye göre çürümüş ağırlık
+// exp(logMass - T ln2 / h) olduğundan aynı T için filmlerin sırası doğrudan logMass'ların sırasıdır.
+//
+// "Şimdi"ye (görülen en yeni puandan sonraki her ana) göre sıra, puanlar geldikçe T'den bağımsız değişmez:
+// ranked bu sırayı tutar, sorgu baştan yürüyüp izlenmemiş k filmi bulunca durur (O(k + atlanan)).
+// Geçmişteki bir an ya da pencere için filmler puan sayısına göre azalan sırayla (byCount) gezilir; pencere
+// sayısı ve ağırlığı puan sayısından büyük olamayacağı için k. adaydan kötü sınıra gelince durulur.
+// Yeni puan satırın sonuna eklenir (zaman sırası bozuksa kuyruk kaydırılır), iki sıra da filmi kaydırarak
+// güncellenir; canlı modda ingest her puanı buraya da işler (bkz. ingest.h).
+
+#define TREND_DAY_SECONDS 86400
+#define TREND_HALF_LIFE_DAYS 7.0  //-T verilmeyen yerlerde (degerlendir) kullanılan yarı ömür
+
+typedef struct TrendIndex {
+    int movies;
+    double halfLife;            //saniye
+    unsigned int lastTime;      //görülen en yeni puanın zamanı
+    long *starts;               //movies, film satırları (büyüyebilen, sonlarında boş yer var)
+    long *ends;
+    long *limits;
+    unsigned int *times;        //satır içinde artan
+    double *logMass;            //satır içinde önek toplamı (yukarıya bakın)
+    long slotsUsed;
+    long slotCount;
+    double *score;              //movies, satırın son önek toplamı; puansız filmde -INFINITY
+    int *ranked;                //movies, score'a göre azalan (eşitte küçük id önce)
+    int *byCount;               //movies, puan sayısına göre azalan (eşitte küçük id önce)
+} TrendIndex;
+
+// Geçmiş ya da pencere sorgusu: [from, to] aralığındaki puanlar (uçlar dahil)
+typedef struct TrendQuery {
+    unsigned int from;
+    unsigned int to;
+    int decay;                  //1: to anına göre çürümüş ağırlık, 0: aralıktaki puan sayısı
+} TrendQuery;
+
+// halfLifeDays > 0; filmler 0 tabanlı
+TrendIndex *buildTrendIndex(const RatingMatrix *matrix, double halfLifeDays);
+void freeTrendIndex(TrendIndex *index);
+
+// Yeni puan (kullanıcı-film çifti ilk kez puanlandı)
+void trendAddRating(TrendIndex *index, int movie, unsigned int time);
+// Var olan puan değişti, zaman damgası oldTime'dan newTime'a geçti
+void trendMoveRating(TrendIndex *index, int movie, unsigned int oldTime, unsigned int newTime);
+
+// Filmin satırında [from, to] aralığına düşen puanlar [*first, *last)
+void trendWindow(const TrendIndex *index, int movie, unsigned int from, unsigned int to, long *first, long *last);
+
+// Kullanıcının (1 tabanlı) izlemediği filmlerden en popüler rec tanesi (1 tabanlı) out'a yazılır.
+// query NULL ise "şimdi"ye göre çürümüş ağırlık kullanılır. items en az rec elemanlık çalışma alanıdır,
+// sadece query verilince kullanılır (NULL olabilir).
+// Aralıkta hiç puanı olmayan film önerilmez.
+int recommendTrending(const TrendIndex *index, const RatingMatrix *matrix, int user, int rec,
+                      const TrendQuery *query, ScoredItem *items, int *out);
+
+#endif
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "loader.h"
+#include "rng.h"
+
+// Sentetik veri üretici: u.data ve u.item biçiminde, istenen boyutta ve aynı tohumla hep aynı dosyalar.
+// Kullanım: ./uret [-u kullanici] [-m film] [-n puan] [-a us] [-s tohum] [-o puanlar] [-i filmler]
+// Kullanıcıların puan sayıları ve filmlerin popülerliği üssü -a olan güç yasasına (Zipf) uyar:
+// k. sıradaki kullanıcı/film 1 / k^a ile orantılı seçilir. Sıralar id'lere rastgele dağıtılır.
+// MovieLens'teki gibi her kullanıcının en az MIN_PER_USER puanı olur (puan sayısı yetiyorsa).
+// Aynı kullanıcı-film çifti iki kez üretilmez. Çıktı u.data gibi karışık sıradadır.
+
+#define MIN_PER_USER 20
+#define MAX_ATTEMPTS 64       //tekrar eden çift gelince en fazla bu kadar yeniden denenir
+#define TIME_START 874724710u //u.data'daki ilk zaman damgası civarı
+#define TIME_SPAN (215u * 86400u)
+
+static double uniform(Rng *rng) {
+    return (rngNext(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Zipf dağılımı için birikimli ağırlıklar; rank[k] k. sıranın id'si (0 tabanlı)
+typedef struct PowerLaw {
+    double *cumulative;
+    int *rank;
+    int count;
+} PowerLaw;
+
+static void initPowerLaw(PowerLaw *law, int count, double exponent, Rng *rng) {
+    law->count = count;
+    law->cumulative = (double *)malloc(count * sizeof(double));
+    law->rank = (int *)malloc(count * sizeof(int));
+    double total = 0;
+    for (int k = 0; k < count; k++) {
+        total += 1.0 / pow(k + 1, exponent);
+        law->cumulative[k] = total;
+        law->rank[k] = k;
+    }
+    for (int k = count - 1; k > 0; k--) {
+        int j = rngRange(rng, k + 1);
+        int temp = law->rank[k];
+        law->rank[k] = law->rank[j];
+        law->rank[j] = temp;
+    }
+}
+
+static int samplePowerLaw(const PowerLaw *law, Rng *rng) {
+    double target = uniform(rng) * law->cumulative[law->count - 1];
+    int low = 0;
+    int high = law->count - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (law->cumulative[mid] < target) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return law->rank[low];
+}
+
+static void freePowerLaw(PowerLaw *law) {
+    free(law->cumulative);
+    free(law->rank);
+}
+
+// Üretilmiş çiftler için açık adresli küme (anahtar kullanici * film sayısı + film, 0 boş yer)
+typedef struct PairSet {
+    uint64_t *keys;
+    uint64_t mask;
+} PairSet;
+
+static int insertPair(PairSet *set, uint64_t key) {
+    key++;  //0 boş yer demek
+    uint64_t slot = (key * 0x9E3779B97F4A7C15ULL) & set->mask;
+    while (set->keys[slot] != 0) {
+        if (set->keys[slot] == key) {
+            return 0;
+        }
+        slot = (slot + 1) & set->mask;
+    }
+    set->keys[slot] = key;
+    return 1;
+}
+
+// Filmin "kalitesi" ve kullanıcının eğilimi toplanıp gürültü eklenir, 1..5'e yuvarlanır
+static int makeRating(double quality, double bias, Rng *rng) {
+    double noise = (uniform(rng) + uniform(rng) + uniform(rng) - 1.5) * 1.6;
+    int rating = (int)lround(quality + bias + noise);
+    return rating < 1 ? 1 : (rating > 5 ? 5 : rating);
+}
+
+static int writeItems(const char *fileName, int movies, Rng *rng) {
+    FILE *out = fopen(fileName, "w");
+    if (!out) {
+        return -1;
+    }
+    for (int m = 1; m <= movies; m++) {
+        unsigned mask = 0;
+        int genreCount = 1 + rngRange(rng, 3);
+        for (int g = 0; g < genreCount; g++) {
+            mask |= 1u << (1 + rngRange(rng, 18));  //0 (unknown) dışındaki türler
+        }
+        fprintf(out, "%d|Sentetik Film %d (1995)|01-Jan-1995||http://example.com/film/%d", m, m, m);
+        for (int g = 0; g < 19; g++) {
+            fprintf(out, "|%d", (mask >> g) & 1);
+        }
+        fputc('\n', out);
+    }
+    return fclose(out);
+}
+
+int main(int argc, char *argv[]) {
+    int users = 943;
+    int movies = 1682;
+    long ratings = 100000;
+    double exponent = 0.8;
+    unsigned long long seed = 42;
+    const char *ratingsFile = "sentetik.data";
+    const char *itemsFile = "sentetik.item";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            users = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            movies = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            ratings = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            exponent = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            ratingsFile = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            itemsFile = argv[++i];
+        } else {
+            printf("Kullanim: %s [-u kullanici] [-m film] [-n puan] [-a us] [-s tohum] [-o puanlar] [-i filmler]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (users < 1 || movies < 1 || ratings < 1 || exponent < 0) {
+        printf("Gecersiz boyut.\n");
+        return 1;
+    }
+    if (ratings > (long)users * movies) {
+        ratings = (long)users * movies;
+    }
+
+    Rng rng;
+    rngSeed(&rng, seed);
+    PowerLaw userLaw, movieLaw;
+    initPowerLaw(&userLaw, users, exponent, &rng);
+    initPowerLaw(&movieLaw, movies, exponent, &rng);
+
+    double *quality = (double *)malloc(movies * sizeof(double));
+    double *bias = (double *)malloc(users * sizeof(double));
+    for (int m = 0; m < movies; m++) {
+        quality[m] = 2.0 + 2.5 * uniform(&rng);
+    }
+    for (int u = 0; u < users; u++) {
+        bias[u] = (uniform(&rng) - 0.5) * 1.4;
+    }
+
+    PairSet pairs;
+    uint64_t capacity = 1024;
+    while (capacity < (uint64_t)ratings * 2) {
+        capacity *= 2;
+    }
+    pairs.keys = (uint64_t *)calloc(capacity, sizeof(uint64_t));
+    pairs.mask = capacity - 1;
+
+    Rating *items = (Rating *)malloc(ratings * sizeof(Rating));
+    long count = 0;
+    int minPerUser = ratings / users < MIN_PER_USER ? (int)(ratings / users) : MIN_PER_USER;
+    if (minPerUser > movies) {
+        minPerUser = movies;
+    }
+
+    // Önce her kullanıcıya en az puanı, sonra kalanlar güç yasasına göre seçilen kullanıcılara
+    for (long i = 0; count < ratings && i < ratings * (long)MAX_ATTEMPTS / 4 + (long)users * minPerUser; i++) {
+        int user = i < (long)users * minPerUser ? (int)(i / minPerUser) : samplePowerLaw(&userLaw, &rng);
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+            int movie = samplePowerLaw(&movieLaw, &rng);
+            if (insertPair(&pairs, (uint64_t)user * movies + movie)) {
+                Rating *r = &items[count++];
+                r->user = user + 1;
+                r->movie = movie + 1;
+                r->rating = makeRating(quality[movie], bias[user], &rng);
+                r->timestamp = TIME_START + (unsigned)rngRange(&rng, (int)TIME_SPAN);
+                break;
+            }
+        }
+    }
+
+    // u.data gibi karışık sıra
+    for (long i = count - 1; i > 0; i--) {
+        long j = (long)(uniform(&rng) * (i + 1));
+        Rating temp = items[i];
+        items[i] = items[j];
+        items[j] = temp;
+    }
+
+    FILE *out = fopen(ratingsFile, "w");
+    if (!out) {
+        printf("Cikti dosyasi acilamadi: %s\n", ratingsFile);
+        return 1;
+    }
+    setvbuf(out, NULL, _IOFBF, 1 << 20);
+    for (long i = 0; i < count; i++) {
+        fprintf(out, "%d\t%d\t%d\t%u\n", items[i].user, items[i].movie, items[i].rating, items[i].timestamp);
+    }
+    if (fclose(out) != 0 || writeItems(itemsFile, movies, &rng) != 0) {
+        printf("Dosyalar yazilamadi.\n");
+        return 1;
+    }
+    printf("%s: %d kullanici, %d film, %ld puan; %s yazildi\n", ratingsFile, users, movies, count, itemsFile);
+
+    free(items);
+    free(pairs.keys);
+    free(quality);
+    free(bias);
+    freePowerLaw(&userLaw);
+    freePowerLaw(&movieLaw);
+    return 0;
+}
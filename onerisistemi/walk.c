@@ -0,0 +1,256 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "walk.h"
+#include "rng.h"
+#include "batch.h"
+#include "metrics.h"
+
+// Bir düğümün kenarları ve tablosundaki yeri
+typedef struct VertexSlots {
+    const int *keys;            //komşu = keys[i] + base
+    const unsigned char *ratings;
+    int base;
+    int degree;
+    float *probability;         //düğümün ilk kenarının yuvasından başlar
+    int *alias;
+} VertexSlots;
+
+static inline void vertexSlots(const WalkTable *table, int vertex, VertexSlots *slots) {
+    const RatingMatrix *matrix = table->matrix;
+    slots->degree = vertexEdges(matrix, vertex, &slots->keys, &slots->ratings, &slots->base);
+    if (vertex < matrix->users) {
+        long start = matrix->rowOffsets[vertex];
+        slots->probability = table->rowProbability + start;
+        slots->alias = table->rowAlias + start;
+    } else {
+        long start = matrix->colOffsets[vertex - matrix->users];
+        slots->probability = table->colProbability + start;
+        slots->alias = table->colAlias + start;
+    }
+}
+
+// Vose yöntemiyle bir düğümün kenarları için alias tablosu.
+// Her yuvanın payı derece * ağırlık / toplam; payı 1'den küçük yuvaların boşluğu, payı büyük bir kenarla doldurulur.
+static void buildAlias(const VertexSlots *slots, double *scaled, int *small, int *large) {
+    int degree = slots->degree;
+    double total = 0;
+    for (int i = 0; i < degree; i++) {
+        scaled[i] = slots->ratings[i]; //kenarın puanı
+        total += scaled[i];
+    }
+
+    int smallCount = 0;
+    int largeCount = 0;
+    for (int i = 0; i < degree; i++) {
+        scaled[i] = scaled[i] * degree / total;
+        if (scaled[i] < 1.0) {
+            small[smallCount++] = i;
+        } else {
+            large[largeCount++] = i;
+        }
+    }
+
+    while (smallCount > 0 && largeCount > 0) {
+        int less = small[--smallCount];
+        int more = large[--largeCount];
+        slots->probability[less] = (float)scaled[less];
+        slots->alias[less] = more;
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0) {
+            small[smallCount++] = more;
+        } else {
+            large[largeCount++] = more;
+        }
+    }
+    // Kalanlar (yuvarlama artıkları dahil) tam paya sahip
+    while (largeCount > 0) {
+        int i = large[--largeCount];
+        slots->probability[i] = 1.0f;
+        slots->alias[i] = i;
+    }
+    while (smallCount > 0) {
+        int i = small[--smallCount];
+        slots->probability[i] = 1.0f;
+        slots->alias[i] = i;
+    }
+}
+
+// Alias kurarken kullanılan geçici diziler en büyük derece kadar tutulur
+static void reserveScratch(WalkTable *table, int degree) {
+    if (degree <= table->scratchCapacity) {
+        return;
+    }
+    table->scratchCapacity = degree;
+    table->scaled = (double *)realloc(table->scaled, degree * sizeof(double));
+    table->small = (int *)realloc(table->small, degree * sizeof(int));
+    table->large = (int *)realloc(table->large, degree * sizeof(int));
+}
+
+static void rebuildVertex(WalkTable *table, int vertex) {
+    VertexSlots slots;
+    vertexSlots(table, vertex, &slots);
+    if (slots.degree > 0) {
+        reserveScratch(table, slots.degree);
+        buildAlias(&slots, table->scaled, table->small, table->large);
+    }
+}
+
+// Sıkışık matriste yuvalar puan sayısı kadardır, büyüyebilende boş yerlerle birlikte ayrılan boy
+static long rowSlotsOf(const RatingMatrix *matrix) {
+    return matrix->rowLimits != NULL ? matrix->rowSlotCount : matrix->nonZeros;
+}
+
+static long colSlotsOf(const RatingMatrix *matrix) {
+    return matrix->colLimits != NULL ? matrix->colSlotCount : matrix->nonZeros;
+}
+
+// Tablo dizileri matrisin yuva dizileriyle birlikte büyür (var olan yuvalar yerinde kalır)
+static void reserveSlots(WalkTable *table) {
+    long rowSlots = rowSlotsOf(table->matrix);
+    long colSlots = colSlotsOf(table->matrix);
+    if (table->rowProbability == NULL || table->rowSlots < rowSlots) {
+        table->rowSlots = rowSlots;
+        table->rowProbability = (float *)realloc(table->rowProbability, (rowSlots > 0 ? rowSlots : 1) * sizeof(float));
+        table->rowAlias = (int *)realloc(table->rowAlias, (rowSlots > 0 ? rowSlots : 1) * sizeof(int));
+    }
+    if (table->colProbability == NULL || table->colSlots < colSlots) {
+        table->colSlots = colSlots;
+        table->colProbability = (float *)realloc(table->colProbability, (colSlots > 0 ? colSlots : 1) * sizeof(float));
+        table->colAlias = (int *)realloc(table->colAlias, (colSlots > 0 ? colSlots : 1) * sizeof(int));
+    }
+}
+
+WalkTable *createWalkTable(const RatingMatrix *matrix) {
+    WalkTable *table = (WalkTable *)calloc(1, sizeof(WalkTable));
+    table->matrix = matrix;
+    reserveSlots(table);
+    int vertices = graphVertices(matrix);
+    for (int v = 0; v < vertices; v++) {
+        rebuildVertex(table, v);
+    }
+    return table;
+}
+
+void updateWalkTable(WalkTable *table, const int *vertices, int count) {
+    reserveSlots(table);
+    for (int i = 0; i < count; i++) {
+        rebuildVertex(table, vertices[i]);
+    }
+}
+
+void freeWalkTable(WalkTable *table) {
+    if (table == NULL) {
+        return;
+    }
+    free(table->rowProbability);
+    free(table->rowAlias);
+    free(table->colProbability);
+    free(table->colAlias);
+    free(table->scaled);
+    free(table->small);
+    free(table->large);
+    free(table);
+}
+
+// Bir adım: rastgele sayının üst 32 biti kenar yuvasını, alt 24 biti yazı-turayı belirler. Kenarı yoksa -1
+static inline int walkStep(const WalkTable *table, int vertex, Rng *rng) {
+    VertexSlots slots;
+    vertexSlots(table, vertex, &slots);
+    if (slots.degree == 0) {
+        return -1;
+    }
+    unsigned long long r = rngNext(rng);
+    int slot = (int)(((r >> 32) * (unsigned long long)slots.degree) >> 32);
+    float coin = (float)(r & 0xFFFFFF) * (1.0f / 16777216.0f);
+    int edge = coin < slots.probability[slot] ? slot : slots.alias[slot];
+    return slots.keys[edge] + slots.base;
+}
+
+// chunk numaralı parçayı yürür ve ziyaretleri visits dizisine ekler
+static void walkChunk(const WalkTable *table, int source, const WalkConfig *config, long chunk, unsigned *visits) {
+    long first = chunk * WALK_CHUNK_STEPS;
+    long steps = config->steps - first < WALK_CHUNK_STEPS ? config->steps - first : WALK_CHUNK_STEPS;
+    unsigned long long restartLimit = config->restart >= 1.0 ? ~0ULL : (unsigned long long)(config->restart * 18446744073709551616.0);
+
+    Rng rng;
+    rngSeed(&rng, config->seed ^ (0x9E3779B97F4A7C15ULL * (unsigned long long)(chunk + 1)));
+
+    int current = source;
+    for (long i = 0; i < steps; i++) {
+        int next = rngNext(&rng) < restartLimit ? source : walkStep(table, current, &rng);
+        if (next < 0) {
+            next = source;  //çıkışı olmayan düğümde de başa dönülür
+        }
+        visits[next]++;
+        current = next;
+    }
+    METRICS_ADD(METRIC_WALK_STEPS, steps);
+}
+
+// İş parçacıklarının paylaştığı durum: sıradaki parça atomik olarak alınır
+typedef struct WalkState {
+    const WalkTable *table;
+    int source;
+    const WalkConfig *config;
+    long chunkCount;
+    long nextChunk;
+} WalkState;
+
+typedef struct WalkWorker {
+    WalkState *state;
+    unsigned *visits; //iş parçacığının kendi sayaçları, sonunda toplanır
+} WalkWorker;
+
+static void *walkWorker(void *arg) {
+    WalkWorker *worker = (WalkWorker *)arg;
+    WalkState *state = worker->state;
+    for (;;) {
+        long chunk = __atomic_fetch_add(&state->nextChunk, 1, __ATOMIC_RELAXED);
+        if (chunk >= state->chunkCount) {
+            break;
+        }
+        walkChunk(state->table, state->source, state->config, chunk, worker->visits);
+    }
+    return NULL;
+}
+
+void walkWithRestart(const WalkTable *table, int source, const WalkConfig *config, unsigned *visits) {
+    int vertices = graphVertices(table->matrix);
+    memset(visits, 0, vertices * sizeof(unsigned));
+    if (config->steps <= 0) {
+        return;
+    }
+
+    long chunkCount = (config->steps + WALK_CHUNK_STEPS - 1) / WALK_CHUNK_STEPS;
+    int threads = config->threads > 0 ? config->threads : defaultThreadCount();
+    if (threads > chunkCount) {
+        threads = (int)chunkCount;
+    }
+
+    if (threads <= 1) {
+        for (long chunk = 0; chunk < chunkCount; chunk++) {
+            walkChunk(table, source, config, chunk, visits);
+        }
+        return;
+    }
+
+    WalkState state = {table, source, config, chunkCount, 0};
+    WalkWorker *workers = (WalkWorker *)malloc(threads * sizeof(WalkWorker));
+    pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        workers[i].state = &state;
+        workers[i].visits = (unsigned *)calloc(vertices, sizeof(unsigned));
+        pthread_create(&ids[i], NULL, walkWorker, &workers[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+        for (int v = 0; v < vertices; v++) {
+            visits[v] += workers[i].visits[v];
+        }
+        free(workers[i].visits);
+    }
+    free(workers);
+    free(ids);
+}
@@ -0,0 +1,51 @@
+#ifndef WALK_H
+#define WALK_H
+
+#include "graph.h"
+
+// Kullanıcı-film grafiği üzerinde yeniden başlatmalı rastgele yürüyüş (random walk with restart,
+// kişiselleştirilmiş PageRank). Bir düğümden komşuya geçiş olasılığı kenarın puanıyla orantılıdır:
+// 5 puanlık kenardan geçme ihtimali 1 puanlıktan 5 kat fazladır.
+//
+// Her düğüm için alias tablosu önceden kurulur, böylece bir adım O(1): rastgele bir kenar yuvası seçilir,
+// yazı-tura ile ya o kenar ya da yuvanın alias kenarı kullanılır.
+
+// Toplam adımlar bu büyüklükte bağımsız parçalara bölünür. Her parçanın kendi tohumu olduğu için
+// sonuç, parçaları kaç iş parçacığının paylaştığından bağımsızdır.
+#define WALK_CHUNK_STEPS 4096
+
+// Tablolar grafiğin kenarları gibi puan deposunun yuvalarına göre dizilir: kullanıcı düğümlerininki satır
+// dizileriyle, film düğümlerininki sütun dizileriyle aynı yerde durur. Her düğümün tablosu kendi kenarlarını
+// kapsar (alias, düğümün ilk kenarına göre sıradır).
+typedef struct WalkTable {
+    const RatingMatrix *matrix;
+    float *rowProbability; //satır yuvası başına, yuva seçilince kendi kenarında kalma olasılığı
+    int *rowAlias;         //kalınmazsa kullanılacak kenar
+    long rowSlots;         //matrisin satır dizileriyle aynı boy
+    float *colProbability; //aynıları sütun yuvaları (film düğümleri) için
+    int *colAlias;
+    long colSlots;
+    double *scaled;        //alias kurarken kullanılan geçici diziler
+    int *small;
+    int *large;
+    int scratchCapacity;
+} WalkTable;
+
+typedef struct WalkConfig {
+    long steps;              //tüm yürüyüşlerdeki toplam adım
+    double restart;          //her adımda kaynağa geri dönme olasılığı
+    int threads;             //1 ise çağıran iş parçacığında çalışır, 0 ise çekirdek sayısı kadar
+    unsigned long long seed;
+} WalkConfig;
+
+WalkTable *createWalkTable(const RatingMatrix *matrix);
+void freeWalkTable(WalkTable *table);
+// Büyüyebilen matriste puanı eklenen ya da değişen düğümlerin tablolarını yeniden kurar. Puan sıralı satıra
+// (sütuna) araya eklendiği için kenarların yeri kayar; düğümün tablosunu kurmak, eklemenin kendisi gibi
+// derecesiyle orantılıdır ve bir grupta düğüm başına bir kez yapılır.
+void updateWalkTable(WalkTable *table, const int *vertices, int count);
+
+// source düğümünden yürüyüşler yapar; visits[v], v düğümüne kaç kez gelindiğidir (vertices elemanlı, sıfırlanır)
+void walkWithRestart(const WalkTable *table, int source, const WalkConfig *config, unsigned *visits);
+
+#endif